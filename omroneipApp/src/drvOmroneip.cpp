@@ -11,6 +11,203 @@ static void readPollerC(void *drvPvt)
   pPvt->readPoller();
 }
 
+static void schedulerC(void *drvPvt)
+{
+  drvOmronEIP *pPvt = (drvOmronEIP *)drvPvt;
+  pPvt->schedulerLoop();
+}
+
+static void writeFlusherC(void *drvPvt)
+{
+  drvOmronEIP *pPvt = (drvOmronEIP *)drvPvt;
+  pPvt->writeFlusher();
+}
+
+static void workerC(void *poolPvt)
+{
+  omronWorkerPool *pPool = (omronWorkerPool *)poolPvt;
+  pPool->workerLoop();
+}
+
+/** Orders schedulerQueue_ as a min-heap, so that the poller with the earliest deadline is at the front */
+static bool laterDeadline(const omronEIPPoller *a, const omronEIPPoller *b)
+{
+  return a->nextDeadline_ > b->nextDeadline_;
+}
+
+/** libplctag calls this from its own thread for every event on a tag which has been registered in registerReadCallbacks() */
+static void tagCallbackC(int32_t tagIndex, int event, int status, void *drvPvt)
+{
+  drvOmronEIP *pPvt = (drvOmronEIP *)drvPvt;
+  pPvt->tagCallback(tagIndex, event, status);
+}
+
+/** Maps each C type onto the libplctag function which sets it, used by encodeNumeric() */
+template <typename T> struct omronCipTraits;
+template <> struct omronCipTraits<epicsInt8>
+{
+  static int set(int32_t tag, int offset, epicsInt8 value) { return plc_tag_set_int8(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsUInt8>
+{
+  static int set(int32_t tag, int offset, epicsUInt8 value) { return plc_tag_set_uint8(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsInt16>
+{
+  static int set(int32_t tag, int offset, epicsInt16 value) { return plc_tag_set_int16(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsUInt16>
+{
+  static int set(int32_t tag, int offset, epicsUInt16 value) { return plc_tag_set_uint16(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsInt32>
+{
+  static int set(int32_t tag, int offset, epicsInt32 value) { return plc_tag_set_int32(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsUInt32>
+{
+  static int set(int32_t tag, int offset, epicsUInt32 value) { return plc_tag_set_uint32(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsInt64>
+{
+  static int set(int32_t tag, int offset, epicsInt64 value) { return plc_tag_set_int64(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsUInt64>
+{
+  static int set(int32_t tag, int offset, epicsUInt64 value) { return plc_tag_set_uint64(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsFloat32>
+{
+  static int set(int32_t tag, int offset, epicsFloat32 value) { return plc_tag_set_float32(tag, offset, value); }
+};
+template <> struct omronCipTraits<epicsFloat64>
+{
+  static int set(int32_t tag, int offset, epicsFloat64 value) { return plc_tag_set_float64(tag, offset, value); }
+};
+
+/** Reverses the bytes of one element in place, written with fixed width integers so that the compiler turns the loops in
+ *  reverseElements() into vector byte shuffles where the target supports them */
+static inline void swapInPlace(uint16_t &value) { value = (uint16_t)((value >> 8) | (value << 8)); }
+static inline void swapInPlace(uint32_t &value)
+{
+  value = ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) | ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
+}
+static inline void swapInPlace(uint64_t &value)
+{
+  uint32_t low = (uint32_t)value;
+  uint32_t high = (uint32_t)(value >> 32);
+  swapInPlace(low);
+  swapInPlace(high);
+  value = ((uint64_t)low << 32) | high;
+}
+
+template <typename T>
+static void reverseElements(uint8_t *data, size_t elements)
+{
+  for (size_t i = 0; i < elements; i++)
+  {
+    T value;
+    memcpy(&value, data + i * sizeof(T), sizeof(T));
+    swapInPlace(value);
+    memcpy(data + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+/** Reverses the byte order of each of the elements of size bytes in data, used for WORD, DWORD and LWORD data */
+static void reverseElements(uint8_t *data, size_t elements, int bytes)
+{
+  if (bytes == 2)
+    reverseElements<uint16_t>(data, elements);
+  else if (bytes == 4)
+    reverseElements<uint32_t>(data, elements);
+  else if (bytes == 8)
+    reverseElements<uint64_t>(data, elements);
+}
+
+/** Copies the first count values of type T from drvUser->snapshot into values, converted from little endian CIP data to the host
+ *  byte order. The bytes are copied rather than read through a T pointer, as the snapshot holds bytes and not T objects. Returns 
+ *  false if the snapshot is too short */
+template <typename T>
+static bool snapshotValues(omronDrvUser_t *drvUser, size_t count, T *values)
+{
+  if (drvUser->snapshot.size() < count * sizeof(T))
+    return false;
+#if EPICS_BYTE_ORDER == EPICS_ENDIAN_BIG
+  reverseElements(drvUser->snapshot.data(), count, sizeof(T));
+#endif
+  memcpy(values, drvUser->snapshot.data(), count * sizeof(T));
+  return true;
+}
+
+/** Unpacks count bools which are packed 8 to a byte, starting at bit firstBit of bytes, into one element of 0 or 1 per bool.
+ *  Whole bytes are unpacked with a fixed inner loop which the compiler can vectorise */
+static void unpackBits(const uint8_t *bytes, int firstBit, size_t count, epicsInt8 *bitmap)
+{
+  size_t i = 0;
+  if (firstBit == 0)
+  {
+    for (; i + 8 <= count; i += 8)
+    {
+      uint8_t byte = bytes[i / 8];
+      for (int k = 0; k < 8; k++)
+        bitmap[i + k] = (byte >> k) & 1;
+    }
+  }
+  for (; i < count; i++)
+  {
+    size_t bitIndex = firstBit + i;
+    bitmap[i] = (bytes[bitIndex / 8] >> (bitIndex % 8)) & 1;
+  }
+}
+
+/** Unpacks count bools which are stored one per byte, as in a regular BOOL array, into one element of 0 or 1 per bool */
+static void unpackBoolBytes(const uint8_t *bytes, int bit, size_t count, epicsInt8 *bitmap)
+{
+  for (size_t i = 0; i < count; i++)
+    bitmap[i] = (bytes[i] >> bit) & 1;
+}
+
+/** Returns the bit offset within the tag of the i'th bool of a BOOL parameter, matching the packing used by readData() */
+static int boolBitOffset(const omronDrvUser_t *drvUser, size_t i)
+{
+  if (drvUser->sliceSize == 1 || drvUser->optimise)
+    return drvUser->tagOffset + i;
+  return drvUser->tagOffset + i * 8;
+}
+
+/** Formats data as upper case hex, only used for trace messages */
+static std::string toHex(const uint8_t *data, size_t size)
+{
+  static const char digits[] = "0123456789ABCDEF";
+  std::string hex(size * 2, '0');
+  for (size_t i = 0; i < size; i++)
+  {
+    hex[2 * i] = digits[data[i] >> 4];
+    hex[2 * i + 1] = digits[data[i] & 0x0F];
+  }
+  return hex;
+}
+
+/** Sets count values of type T in the tags buffer starting at offset. If nElements is less than count, the remaining values
+ *  are set to zero. Returns the first libplctag error, or PLCTAG_STATUS_OK */
+template <typename T, typename epicsType>
+static int encodeNumeric(int32_t tagIndex, int offset, const epicsType *value, size_t nElements, size_t count)
+{
+  int status = PLCTAG_STATUS_OK;
+  size_t i = 0;
+#if EPICS_BYTE_ORDER == EPICS_ENDIAN_LITTLE
+  if (sizeof(T) == sizeof(epicsType) && nElements > 1)
+  {
+    // The PLC stores values little endian, the same as this host, so arrays of the same width are copied in one call
+    i = std::min(nElements, count);
+    status = plc_tag_set_raw_bytes(tagIndex, offset, (uint8_t *)value, i * sizeof(T));
+  }
+#endif
+  for (; i < count && status >= 0; i++)
+    status = omronCipTraits<T>::set(tagIndex, offset + i * sizeof(T), i < nElements ? (T)value[i] : (T)0);
+  return status;
+}
+
 /** This thread runs once after iocInit to optimise the tag map before setting startPollers_=1 to begin the polling threads*/
 static int optimiseTagsC(void *drvPvt)
 {
@@ -27,8 +224,87 @@ omronEIPPoller::omronEIPPoller(const char *portName, const char *pollerName, dou
                                                                                                                       pollerName_(pollerName),
                                                                                                                       updateRate_(updateRate),
                                                                                                                       spreadRequests_(spreadRequests),
-                                                                                                                      myTagCount_(0)
+                                                                                                                      myTagCount_(0),
+                                                                                                                      overrunPolicy_(overrunRunLate),
+                                                                                                                      phaseOffset_(0),
+                                                                                                                      autoPhase_(false),
+                                                                                                                      nextCycle_(0),
+                                                                                                                      repliesChecked_(0),
+                                                                                                                      cycleCount_(0),
+                                                                                                                      overrunCount_(0),
+                                                                                                                      skippedCycles_(0),
+                                                                                                                      lastCycleTime_(0),
+                                                                                                                      maxCycleTime_(0),
+                                                                                                                      inFlight_(0),
+                                                                                                                      targetInFlight_(2),
+                                                                                                                      rttEstimate_(0),
+                                                                                                                      maxInFlight_(0),
+                                                                                                                      readCycle_(-1),
+                                                                                                                      priority_(0),
+                                                                                                                      budgetSkips_(0),
+                                                                                                                      onDemand_(false),
+                                                                                                                      windowRequests_(0),
+                                                                                                                      windowOccupancySum_(0),
+                                                                                                                      windowFullCount_(0),
+                                                                                                                      windowSkips_(0)
+{
+  readComplete_ = epicsEventMustCreate(epicsEventEmpty);
+  decodeDone_ = epicsEventMustCreate(epicsEventEmpty);
+  threadExited_ = NULL;
+  pacingLock_ = epicsMutexMustCreate();
+}
+
+void omronEIPPoller::pacedReadFinished(double roundTripTime, bool success)
+{
+  const double rttGain = 0.125;        // Weight given to each new round trip time sample
+  const double congestionFactor = 2.0; // A reply taking this many times longer than average means the PLC is queueing our requests
+  const double maxInFlight = 64;
+  epicsMutexMustLock(pacingLock_);
+  bool congested = !success || (rttEstimate_ > 0 && roundTripTime > congestionFactor * rttEstimate_);
+  if (success)
+    rttEstimate_ = (rttEstimate_ == 0) ? roundTripTime : rttEstimate_ + rttGain * (roundTripTime - rttEstimate_);
+  if (congested)
+    targetInFlight_ = std::max(1.0, targetInFlight_ / 2);
+  else
+    targetInFlight_ = std::min(maxInFlight, targetInFlight_ + 1 / targetInFlight_); // grows by roughly one per round trip
+  epicsMutexUnlock(pacingLock_);
+}
+
+void omronEIPPoller::startSchedule(std::chrono::steady_clock::time_point now)
+{
+  phaseReference_ = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(phaseOffset_));
+  nextCycle_ = 0;
+  nextDeadline_ = phaseReference_;
+}
+
+bool omronEIPPoller::scheduleNextCycle(std::chrono::steady_clock::time_point now)
 {
+  std::chrono::duration<double> interval(updateRate_);
+  bool overrun = false;
+  nextCycle_++;
+  nextDeadline_ = phaseReference_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval * (double)nextCycle_);
+  if (nextDeadline_ >= now)
+    return overrun;
+
+  overrun = true;
+  overrunCount_++;
+  if (overrunPolicy_ == overrunRunLate)
+  {
+    // Start again now and keep the interval between cycles from here on
+    phaseReference_ = now;
+    nextCycle_ = 0;
+    nextDeadline_ = now;
+  }
+  else if (overrunPolicy_ == overrunSkip)
+  {
+    // Jump to the first deadline on the original phase which has not already passed
+    int64_t dueCycle = (int64_t)std::ceil(std::chrono::duration<double>(now - phaseReference_).count() / updateRate_);
+    skippedCycles_ += dueCycle - nextCycle_;
+    nextCycle_ = dueCycle;
+    nextDeadline_ = phaseReference_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval * (double)nextCycle_);
+  }
+  // For overrunCatchUp the deadline has already passed, so the next cycle starts straight away until we have caught up
+  return overrun;
 }
 
 /** Gives the read pollers time to finish their processing loop and sets omronExiting to true to tell the pollers to destruct */
@@ -87,6 +363,25 @@ drvOmronEIP::drvOmronEIP(const char *portName,
   } 
   // Some of these max message sizes may be higher?
 
+  workerPool_ = NULL;
+  decodePool_ = NULL;
+  decodeChunkSize_ = 0;
+  bandwidth_ = NULL;
+  asyncWrites_ = false;
+  writeCompletions_ = NULL;
+  asyncWritesSent_ = 0;
+  asyncWritesFailed_ = 0;
+  coalescedWrites_ = 0;
+  coalesceWindow_ = 0;
+  writeLock_ = epicsMutexMustCreate();
+  flushWake_ = epicsEventMustCreate(epicsEventEmpty);
+  writeDone_ = epicsEventMustCreate(epicsEventEmpty);
+  writeFlusherExited_ = NULL;
+  demandLock_ = epicsMutexMustCreate();
+  schedulerLock_ = epicsMutexMustCreate();
+  schedulerWake_ = epicsEventMustCreate(epicsEventEmpty);
+  schedulerExited_ = NULL;
+
   epicsAtExit(omronExitCallback, this);
   plc_tag_set_debug_level(debugLevel);
   initHookRegister(myInitHookFunction);
@@ -103,16 +398,168 @@ drvOmronEIP::drvOmronEIP(const char *portName,
   initialized_ = true;
 }
 
-asynStatus drvOmronEIP::createPoller(const char *portName, const char *pollerName, double updateRate, int spreadRequests)
+asynStatus drvOmronEIP::createPoller(const char *portName, const char *pollerName, double updateRate, int spreadRequests, const char *pollerOptions)
 {
+  static const char *functionName = "createPoller";
   int status;
+  drvInfoMap options = this->utilities->pollerOptionsParser(pollerOptions);
+  if (options.at("optionsValid") != "true")
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid options for poller: %s. The poller was not created!\n", driverName, functionName, pollerName);
+    return asynError;
+  }
   omronEIPPoller *pPoller = new omronEIPPoller(portName, pollerName, updateRate, spreadRequests);
+  if (options.at("overrun") == "skip")
+    pPoller->overrunPolicy_ = overrunSkip;
+  else if (options.at("overrun") == "catch_up")
+    pPoller->overrunPolicy_ = overrunCatchUp;
+  else
+    pPoller->overrunPolicy_ = overrunRunLate;
+  pPoller->maxInFlight_ = std::stoi(options.at("max_in_flight"));
+  pPoller->onDemand_ = (options.at("on_demand") == "1");
+  pPoller->priority_ = std::stoi(options.at("priority"));
+  if (options.at("phase_offset") == "auto")
+    pPoller->autoPhase_ = true;
+  else
+    pPoller->phaseOffset_ = std::stod(options.at("phase_offset"));
   pollerList_[pPoller->pollerName_] = pPoller;
+  if (workerPool_ != NULL)
+  {
+    // The scheduler thread runs this poller, it is added to the schedulerQueue_ when the pollers start
+    return asynSuccess;
+  }
+  pPoller->threadExited_ = epicsEventMustCreate(epicsEventEmpty);
   status = (epicsThreadCreate(pPoller->pollerName_,
                               epicsThreadPriorityMedium,
                               epicsThreadGetStackSize(epicsThreadStackMedium),
                               (EPICSTHREADFUNC)readPollerC,
                               this) == NULL);
+  if (status)
+  {
+    epicsEventDestroy(pPoller->threadExited_);
+    pPoller->threadExited_ = NULL;
+  }
+  return (asynStatus)status;
+}
+
+asynStatus drvOmronEIP::createScheduler(int workerThreads)
+{
+  static const char *functionName = "createScheduler";
+  if (!pollerList_.empty())
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, The scheduler must be configured before any pollers are created!\n", driverName, functionName);
+    return asynError;
+  }
+  if (workerPool_ != NULL)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, The scheduler has already been configured!\n", driverName, functionName);
+    return asynError;
+  }
+  if (workerThreads < 1)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, At least one worker thread is needed, using 1 instead of %d.\n", driverName, functionName, workerThreads);
+    workerThreads = 1;
+  }
+  std::string poolName = (std::string)portName + "_worker";
+  workerPool_ = new omronWorkerPool(poolName.c_str(), workerThreads);
+  std::string schedulerName = (std::string)portName + "_scheduler";
+  schedulerExited_ = epicsEventMustCreate(epicsEventEmpty);
+  int status = (epicsThreadCreate(schedulerName.c_str(),
+                                  epicsThreadPriorityMedium,
+                                  epicsThreadGetStackSize(epicsThreadStackMedium),
+                                  (EPICSTHREADFUNC)schedulerC,
+                                  this) == NULL);
+  if (status)
+  {
+    epicsEventDestroy(schedulerExited_);
+    schedulerExited_ = NULL;
+  }
+  return (asynStatus)status;
+}
+
+asynStatus drvOmronEIP::createDecodeWorkers(int workerThreads, int chunkSize)
+{
+  static const char *functionName = "createDecodeWorkers";
+  if (decodePool_ != NULL)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, The decode workers have already been configured!\n", driverName, functionName);
+    return asynError;
+  }
+  if (workerThreads < 1 || chunkSize < 1)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, workerThreads and chunkSize must both be at least 1!\n", driverName, functionName);
+    return asynError;
+  }
+  std::string poolName = (std::string)portName + "_decode";
+  decodeChunkSize_ = chunkSize;
+  decodePool_ = new omronWorkerPool(poolName.c_str(), workerThreads);
+  return asynSuccess;
+}
+
+asynStatus drvOmronEIP::createBandwidthLimit(double bytesPerSec, double requestsPerSec)
+{
+  static const char *functionName = "createBandwidthLimit";
+  if (bandwidth_ != NULL)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, The bandwidth limit has already been configured!\n", driverName, functionName);
+    return asynError;
+  }
+  if (bytesPerSec < 0 || requestsPerSec < 0 || (bytesPerSec == 0 && requestsPerSec == 0))
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, At least one limit must be set and neither can be negative!\n", driverName, functionName);
+    return asynError;
+  }
+  bandwidth_ = new omronTokenBucket(bytesPerSec, requestsPerSec);
+  return asynSuccess;
+}
+
+asynStatus drvOmronEIP::configureWrites(int asyncWrites, double coalesceWindow)
+{
+  static const char *functionName = "configureWrites";
+  if (startPollers_ || iocStarted)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Writes must be configured before iocInit!\n", driverName, functionName);
+    return asynError;
+  }
+  if (writeCompletions_ != NULL)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, The writes have already been configured!\n", driverName, functionName);
+    return asynError;
+  }
+  if (coalesceWindow < 0)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, coalesceWindow cannot be negative!\n", driverName, functionName);
+    return asynError;
+  }
+  if (coalesceWindow > 0 && asyncWrites == 0)
+  {
+    // Records cannot wait for a write which has not been sent yet
+    asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Write coalescing needs asynchronous writes, enabling them.\n", driverName, functionName);
+    asyncWrites = 1;
+  }
+  asyncWrites_ = (asyncWrites != 0);
+  if (!asyncWrites_)
+    return asynSuccess;
+  // asyn completes an output record when the write override returns, which is before the PLC has replied if the write is queued
+  if (coalesceWindow > 0)
+    asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Coalesced writes complete their records before they are sent. A failed write only raises an alarm on records which read back the parameter, give output records info(asyn:READBACK, \"1\").\n",
+              driverName, functionName);
+  std::string poolName = (std::string)portName + "_writes";
+  writeCompletions_ = new omronWorkerPool(poolName.c_str(), 1);
+  coalesceWindow_ = coalesceWindow;
+  // Sends the writes which were queued behind a write in flight or in the coalescing window
+  std::string threadName = (std::string)portName + "_writeQueue";
+  writeFlusherExited_ = epicsEventMustCreate(epicsEventEmpty);
+  int status = (epicsThreadCreate(threadName.c_str(),
+                                  epicsThreadPriorityMedium,
+                                  epicsThreadGetStackSize(epicsThreadStackMedium),
+                                  (EPICSTHREADFUNC)writeFlusherC,
+                                  this) == NULL);
+  if (status)
+  {
+    epicsEventDestroy(writeFlusherExited_);
+    writeFlusherExited_ = NULL;
+  }
   return (asynStatus)status;
 }
 
@@ -205,7 +652,7 @@ asynStatus drvOmronEIP::drvUserCreate(asynUser *pasynUser, const char *drvInfo,
 
     /* Initialise the drvUser datatype which will store everything need to access data for a tag */
     /* Some of these values may be updated during optimisations and some may become outdated */
-    omronDrvUser_t *newDrvUser = (omronDrvUser_t *)callocMustSucceed(1, sizeof(omronDrvUser_t), functionName);
+    omronDrvUser_t *newDrvUser = new omronDrvUser_t();
     if (libplctagStatus == PLCTAG_STATUS_OK && keyWords.at("stringValid") == "true")
     {
       /* Copy values from keyWords map into newDrvUser*/
@@ -329,6 +776,7 @@ asynStatus drvOmronEIP::drvUserCreate(asynUser *pasynUser, const char *drvInfo,
         // Add successfull tags to the tagMap
         tagMap_[asynIndex] = newDrvUser;
         readData(newDrvUser, asynIndex); // do initial read of read and write tags
+        updateTimeStamp();
         callParamCallbacks();
         asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Created libplctag tag with tag index: %d, asyn index: %d and tag string: %s\n", driverName, functionName, tagIndex, asynIndex, tag.c_str());
       }
@@ -368,9 +816,10 @@ asynStatus drvOmronEIP::drvUserCreate(asynUser *pasynUser, const char *drvInfo,
 
 void drvOmronEIP::initialiseDrvUser(omronDrvUser_t *newDrvUser, const drvInfoMap keyWords, int tagIndex, std::string tag, bool readFlag, const asynUser *pasynUser)
 {
-  for (auto type : omronDataTypeList)
-    if (type.first == keyWords.at("dataType")) {
-      newDrvUser->dataType = type;
+  for (size_t i = 0; i < omronDataTypeList.size(); i++)
+    if (omronDataTypeList[i].first == keyWords.at("dataType")) {
+      newDrvUser->dataType = omronDataTypeList[i];
+      newDrvUser->cipType = (omronCipType_t)i;
       break;
     }
   newDrvUser->tag = tag;
@@ -385,7 +834,17 @@ void drvOmronEIP::initialiseDrvUser(omronDrvUser_t *newDrvUser, const drvInfoMap
   newDrvUser->readFlag = readFlag;
   newDrvUser->offsetReadSize = std::stoi(keyWords.at("offsetReadSize"));
   newDrvUser->readAsString = std::stoi(keyWords.at("readAsString"));
+  newDrvUser->timeDecimals = std::stoi(keyWords.at("timeDecimals"));
   newDrvUser->optimise = std::stoi(keyWords.at("optimise"));
+  newDrvUser->publishOnChange = std::stoi(keyWords.at("publishOnChange"));
+  newDrvUser->shadowValid = false;
+  std::string deadband = keyWords.at("deadband");
+  newDrvUser->deadbandPercent = (deadband.back() == '%');
+  newDrvUser->deadband = std::stod(newDrvUser->deadbandPercent ? deadband.substr(0, deadband.size() - 1) : deadband);
+  newDrvUser->lastPublishedValid = false;
+  newDrvUser->pollEvery = std::stoi(keyWords.at("pollEvery"));
+  newDrvUser->pollPhase = 0;
+  newDrvUser->plcTimestamp = std::stoi(keyWords.at("plcTimestamp"));
 }
 
 asynStatus drvOmronEIP::findOptimisableTags(std::unordered_map<std::string, std::vector<int>> &commonStructMap)
@@ -483,7 +942,7 @@ asynStatus drvOmronEIP::findArrayOptimisations(std::unordered_map<std::string, s
   }
 
   // Print debugging info
-  if (!commonArrayMap.empty()){
+  if (!commonArrayMap.empty() && (pasynTrace->getTraceMask(pasynUserSelf) & ASYN_TRACE_FLOW)){
     std::string flowString;
     asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Found the following array slicing optimisations: \n", 
                 driverName, functionName);
@@ -496,7 +955,7 @@ asynStatus drvOmronEIP::findArrayOptimisations(std::unordered_map<std::string, s
       asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s %s \n", driverName, functionName, flowString.c_str());
     }
   }
-  else {
+  else if (commonArrayMap.empty()) {
     asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Found no possible array slicing optimisations. \n", 
                 driverName, functionName);
   }
@@ -573,7 +1032,7 @@ asynStatus drvOmronEIP::createOptimisedArrayTags(std::unordered_map<std::string,
           int elementSize = (plc_tag_get_size(tagIndex)/maxSlice);
           int oldOffset = tagMap_.find(asynIndex)->second->tagOffset;
           int newOffset;
-          if (tagMap_.find(asynIndex)->second->dataType.first == "BOOL"){
+          if (tagMap_.find(asynIndex)->second->cipType == omronTypeBOOL){
             newOffset = oldOffset + 8*(elementSize * (index-sliceStart));
           }
           else {
@@ -774,7 +1233,7 @@ asynStatus drvOmronEIP::optimiseTags()
     if (status==asynSuccess)
       status = createOptimisedTags(structIDMap, commonStructMap, structTagMap);
 
-    if (status==asynSuccess) {
+    if (status==asynSuccess && (pasynTrace->getTraceMask(pasynUserSelf) & ASYN_TRACE_FLOW)) {
       std::string flowString;
       for (auto const &i : commonStructMap)
       {
@@ -805,6 +1264,13 @@ asynStatus drvOmronEIP::optimiseTags()
     }
   }
 
+  // The tag indexes used by each asyn parameter are now final, so we can give each poller its own list of work and tell libplctag
+  // which pollers to wake when a read completes
+  buildPollerLists();
+  assignPhaseOffsets();
+  if (registerReadCallbacks() != asynSuccess)
+    status = asynError;
+
   if (status != asynSuccess) 
     asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Err, Errors detected during optimisation! You should fix these.\n", driverName, functionName);
   else
@@ -815,323 +1281,649 @@ asynStatus drvOmronEIP::optimiseTags()
   return status;
 }
  
-asynStatus drvOmronEIP::loadStructFile(const char *portName, const char *filePath)
+asynStatus drvOmronEIP::buildPollerLists()
 {
-  const char *functionName = "loadStructFile";
-  std::ifstream infile(filePath);
-  structDtypeMap structMap;
-  std::vector<std::string> row;
-  std::string line, word;
-  asynStatus status = asynSuccess;
-
-  if (infile.fail())
+  const char *functionName = "buildPollerLists";
+  omronPollEntry_t entry;
+  for (auto thisTag : tagMap_)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Could not find file: %s. Either missing or invalid permissions.\n", driverName, functionName, filePath);
-    return asynError;
+    if (thisTag.second->pollerName == "none")
+      continue;
+    auto pollerIt = pollerList_.find(thisTag.second->pollerName);
+    if (pollerIt == pollerList_.end())
+      continue;
+    entry.drvUser = thisTag.second;
+    entry.asynIndex = thisTag.first;
+    pollerIt->second->decodeList_.push_back(entry);
+    if (thisTag.second->readFlag == true)
+      pollerIt->second->readList_.push_back(entry);
   }
 
-  if (!structMap_.empty())
+  auto byTagIndex = [](const omronPollEntry_t &a, const omronPollEntry_t &b) {
+    if (a.drvUser->tagIndex != b.drvUser->tagIndex)
+      return a.drvUser->tagIndex < b.drvUser->tagIndex;
+    return a.asynIndex < b.asynIndex;
+  };
+  for (auto poller : pollerList_)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Only one structure definition file can be loaded at once!\n", driverName, functionName);
-    return asynError;
+    std::sort(poller.second->readList_.begin(), poller.second->readList_.end(), byTagIndex);
+    std::sort(poller.second->decodeList_.begin(), poller.second->decodeList_.end(), byTagIndex);
+    staggerPollPhases(poller.second);
+    poller.second->myTagCount_ = poller.second->readList_.size();
+    asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Poller: %s reads %ld tags and updates %ld asyn parameters\n", 
+                driverName, functionName, poller.first.c_str(), poller.second->readList_.size(), poller.second->decodeList_.size());
   }
+  return asynSuccess;
+}
 
-  while (std::getline(infile, line))
+void drvOmronEIP::assignPhaseOffsets()
+{
+  static const char *functionName = "assignPhaseOffsets";
+  std::vector<omronEIPPoller*> autoPollers;
+  for (auto poller : pollerList_)
   {
-    row.clear();
-    std::istringstream s(line);
-    while (std::getline(s, word, ','))
-    {
-      if (word[0] == '#')
-        break;
-      row.push_back(word);
-    }
-    if (row.size() == 1)
-    {
-      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s structure: %s contains no valid members\n", driverName, functionName, row[0].c_str());
-    }
-    else if (!row.empty())
-    {
-      std::string structName = row.front();
-      row.erase(row.begin());
-      structMap[structName] = row;
-    }
+    if (poller.second->autoPhase_)
+      autoPollers.push_back(poller.second);
   }
-
-  std::string flowString;
-  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Loading in struct file with the following definitions:\n", driverName, functionName);
-  for (auto const &i : structMap)
+  // Sort by name so that the offsets do not change between restarts of the IOC
+  std::sort(autoPollers.begin(), autoPollers.end(), [](const omronEIPPoller *a, const omronEIPPoller *b) { return strcmp(a->pollerName_, b->pollerName_) < 0; });
+  for (size_t i = 0; i < autoPollers.size(); i++)
   {
-    flowString += i.first + ": ";
-    for (auto const &j : i.second)
-      flowString += j + " ";
-    asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s\n", flowString.c_str());
-    flowString.clear();
+    autoPollers[i]->phaseOffset_ = autoPollers[i]->updateRate_ * i / autoPollers.size();
+    asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Poller: %s has a phase offset of %f seconds\n", 
+                driverName, functionName, autoPollers[i]->pollerName_, autoPollers[i]->phaseOffset_);
   }
-  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "\n");
-  status = this->utilities->createStructMap(structMap);
-  return status;
 }
 
-void drvOmronEIP::readData(omronDrvUser_t *drvUser, int asynIndex)
+void drvOmronEIP::staggerPollPhases(omronEIPPoller *pPoller)
 {
-  const char *functionName = "extractFetchedData";
-  int status;
-  std::string datatype = drvUser->dataType.first;
-  int offset = drvUser->tagOffset;
-  int sliceSize = drvUser->sliceSize;
-  int still_pending = 1;
-  bool readFailed = false;
-  auto timeoutStartTime = std::chrono::system_clock::now();
-  double timeoutTimeTaken = 0; // time that we have been waiting for the current read request to be answered
-  asynParamType myParam;
-  getParamType(asynIndex, &myParam);
-  // libplctag has thread protection for single API calls. However thedfsdddre is potential that while we are reading a tag on this poller,
-  // from the plc, we can be simultaneously reading data from the tag in libplctag. This could lead to the data being read, being
-  // overwritten as it is read, therefor we must lock the tag while reading it.
-  status = plc_tag_lock(drvUser->tagIndex);
-  if (status != 0)
+  const int64_t maxHorizon = 3600; // bounds the work done here if the poll_every values have a very large lowest common multiple
+  std::vector<omronDrvUser_t*> slowTags;
+  int64_t horizon = 1;
+  for (const omronPollEntry_t &entry : pPoller->readList_)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, while locking Tag index: %d libplctag reports: %s\n",
-              driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-    return;
+    if (entry.drvUser->pollEvery <= 1)
+      continue;
+    slowTags.push_back(entry.drvUser);
+    int64_t a = horizon, b = entry.drvUser->pollEvery;
+    while (b != 0) { int64_t t = a % b; a = b; b = t; } // a is now the greatest common divisor
+    horizon = std::min(maxHorizon, horizon / a * entry.drvUser->pollEvery);
   }
-  while (still_pending)
+  if (slowTags.empty())
+    return;
+
+  // Place the slowest tags first, then put each tag on the phase where the busiest cycle it would be read in has the fewest reads
+  std::stable_sort(slowTags.begin(), slowTags.end(), [](const omronDrvUser_t *a, const omronDrvUser_t *b) { return a->pollEvery > b->pollEvery; });
+  std::vector<size_t> cycleLoad(horizon, 0);
+  for (omronDrvUser_t *drvUser : slowTags)
   {
-    status = plc_tag_status(drvUser->tagIndex);
-    // It should be rare that data for the first tag has not arrived before the last tag is read
-    // Therefore this if statement will normally be skipped, or called once by the first few tags as we
-    // are asynchronously waiting for all tags in this poller to be read.
-    if (status == PLCTAG_STATUS_PENDING)
+    int bestPhase = 0;
+    size_t bestLoad = SIZE_MAX;
+    for (int phase = 0; phase < drvUser->pollEvery && phase < horizon; phase++)
     {
-      epicsThreadSleep(0.01);
-      timeoutTimeTaken = (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - timeoutStartTime).count()) * 0.001; // seconds
-      // We wait so that we dont spam libplctag with status requests which can cause 100ms freezes
-      if (timeoutTimeTaken >= drvUser->timeout)
+      size_t load = 0;
+      for (int64_t cycle = phase; cycle < horizon; cycle += drvUser->pollEvery)
+        load = std::max(load, cycleLoad[cycle]);
+      if (load < bestLoad)
       {
-        // If the timeout specified in the records INP/OUT field is hit, we set the status to asynTimeout
-        // To be precise, this is the timeout to enter this loop is the time between the last read request for this poller being sent and the current time,
-        // this means that the first read requests will have slightly longer than their timeout period for their data to return.
-        setParamStatus(asynIndex, asynTimeout);
-        setParamAlarmStatus(asynIndex, asynTimeout);
-        setParamAlarmSeverity(asynIndex, MAJOR_ALARM);
-        readFailed = true;
-        asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Timeout finishing read tag %d: %s. Decrease the polling rate or increase the timeout.\n",
-                  driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-        still_pending = 0;
+        bestLoad = load;
+        bestPhase = phase;
       }
     }
-    else if (status < 0)
+    drvUser->pollPhase = bestPhase;
+    for (int64_t cycle = bestPhase; cycle < horizon; cycle += drvUser->pollEvery)
+      cycleLoad[cycle]++;
+  }
+}
+
+asynStatus drvOmronEIP::registerReadCallbacks()
+{
+  const char *functionName = "registerReadCallbacks";
+  asynStatus status = asynSuccess;
+  int libplctagStatus;
+  // A tag may be read by one poller and decoded by parameters on several pollers (optimised tags), all of these pollers must be woken
+  for (auto poller : pollerList_)
+  {
+    for (const omronPollEntry_t &entry : poller.second->decodeList_)
     {
-      setParamStatus(asynIndex, asynError);
-      setParamAlarmStatus(asynIndex, asynError);
-      setParamAlarmSeverity(asynIndex, MAJOR_ALARM);
-      readFailed = true;
-      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, finishing read of tag %d: %s\n",
-                driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-      still_pending = 0;
+      if (entry.drvUser->tagIndex <= 0)
+        continue;
+      std::vector<omronEIPPoller*> &pollers = tagStates_[entry.drvUser->tagIndex].pollers;
+      if (std::find(pollers.begin(), pollers.end(), poller.second) == pollers.end())
+        pollers.push_back(poller.second);
+      if (entry.drvUser->plcTimestamp)
+        tagStates_[entry.drvUser->tagIndex].timestampSource = entry.drvUser;
     }
-    else
+    for (const omronPollEntry_t &entry : poller.second->readList_)
     {
-      still_pending = 0;
+      if (entry.drvUser->tagIndex > 0)
+      {
+        omronTagState_t &tagState = tagStates_[entry.drvUser->tagIndex];
+        tagState.reader = poller.second;
+        tagState.pollEvery = entry.drvUser->pollEvery;
+        tagState.pollPhase = entry.drvUser->pollPhase;
+      }
     }
   }
-
-  if (!readFailed)
+  // Tags which are only written need a callback too, so that we hear when their asynchronous writes finish
+  if (asyncWrites_)
   {
-    if (datatype == "BOOL")
+    for (auto tag : tagMap_)
     {
-      uint8_t dataIn [4];
-      epicsUInt32 dataOut = 0;
-      std::string printData;
-      if (sliceSize == 1){
-        dataOut = plc_tag_get_bit(drvUser->tagIndex, offset); // takes a bit offset
-      }
-      else if (drvUser->optimise && sliceSize <= 32)
-      {
-        // If optimising and slice size is not 1, we are getting bools from an embedded array where they are packed at the bit level (1byte=8bools)
-        status = plc_tag_get_raw_bytes(drvUser->tagIndex, offset/8, dataIn, ((sliceSize-1)/8)+1);
-        //combine 4 uint8 into a epicsUInt32
-        dataOut = dataIn[0] | (dataIn[1] << 8) | (dataIn[2] << 16) | (dataIn[3] << 24);
-      }
-      else if (sliceSize <= 32)
-      {
-        // We are getting bools from a regular bool array where they are packed at the byte level (1byte=1bool)
-        // We read up to 32 bits from the bit array, passing a byte offset to the array and specifying the number of bytes to read
-        for (int i =0;i<sliceSize;i++){
-          uint8_t thisBool = plc_tag_get_bit(drvUser->tagIndex, offset+i*8);
-          dataOut = dataOut | thisBool<<i;
-        }
-      }
-      else{
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Asyn index: %d Max slice size for BOOL type is 32, recieved: %d\n",
-                  driverName, functionName, asynIndex, sliceSize);
-      }
+      if (tag.second->tagIndex > 0)
+        tagStates_[tag.second->tagIndex];
+    }
+  }
 
-      if (status != PLCTAG_STATUS_OK)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while reading BOOL array: %s\n",
-                  driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-        return;
-      }
-      status = setUIntDigitalParam(asynIndex, dataOut, 0xFFFFFFFF, 0xFFFFFFFF);
-      printData = std::bitset<32>(dataOut).to_string();
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, printData.c_str(), datatype.c_str());
+  for (auto &tagState : tagStates_)
+  {
+    libplctagStatus = plc_tag_register_callback_ex(tagState.first, tagCallbackC, this);
+    if (libplctagStatus != PLCTAG_STATUS_OK)
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, failed to register read callback for tag index: %d. libplctag reports: %s\n",
+                driverName, functionName, tagState.first, plc_tag_decode_error(libplctagStatus));
+      status = asynError;
     }
-    else if (datatype == "SINT")
+  }
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Registered read callbacks for %ld polled libplctag tags\n", driverName, functionName, tagStates_.size());
+  return status;
+}
+
+asynStatus drvOmronEIP::publishInteger(omronUpdateList *updates, int asynIndex, epicsInt32 value)
+{
+  if (updates == NULL)
+    return setIntegerParam(asynIndex, value);
+  updates->push_back([this, asynIndex, value]() { return setIntegerParam(asynIndex, value); });
+  return asynSuccess;
+}
+
+asynStatus drvOmronEIP::publishInteger64(omronUpdateList *updates, int asynIndex, epicsInt64 value)
+{
+  if (updates == NULL)
+    return setInteger64Param(asynIndex, value);
+  updates->push_back([this, asynIndex, value]() { return setInteger64Param(asynIndex, value); });
+  return asynSuccess;
+}
+
+asynStatus drvOmronEIP::publishDouble(omronUpdateList *updates, int asynIndex, epicsFloat64 value)
+{
+  if (updates == NULL)
+    return setDoubleParam(asynIndex, value);
+  updates->push_back([this, asynIndex, value]() { return setDoubleParam(asynIndex, value); });
+  return asynSuccess;
+}
+
+asynStatus drvOmronEIP::publishString(omronUpdateList *updates, int asynIndex, const char *value)
+{
+  if (updates == NULL)
+    return setStringParam(asynIndex, value);
+  std::string copy(value);
+  updates->push_back([this, asynIndex, copy]() { return setStringParam(asynIndex, copy.c_str()); });
+  return asynSuccess;
+}
+
+asynStatus drvOmronEIP::publishUIntDigital(omronUpdateList *updates, int asynIndex, epicsUInt32 value, epicsUInt32 valueMask, epicsUInt32 interruptMask)
+{
+  if (updates == NULL)
+    return setUIntDigitalParam(asynIndex, value, valueMask, interruptMask);
+  updates->push_back([this, asynIndex, value, valueMask, interruptMask]() { return setUIntDigitalParam(asynIndex, value, valueMask, interruptMask); });
+  return asynSuccess;
+}
+
+template <typename epicsType>
+asynStatus drvOmronEIP::publishArray(omronUpdateList *updates, asynStatus (asynPortDriver::*doCallbacks)(epicsType *, size_t, int, int),
+                                     epicsType *value, size_t nElements, int asynIndex)
+{
+  if (updates == NULL)
+    return (this->*doCallbacks)(value, nElements, asynIndex, 0);
+  std::shared_ptr<std::vector<epicsType>> copy = std::make_shared<std::vector<epicsType>>(value, value + nElements);
+  updates->push_back([this, doCallbacks, copy, asynIndex]() { return (this->*doCallbacks)(copy->data(), copy->size(), asynIndex, 0); });
+  return asynSuccess;
+}
+
+void drvOmronEIP::publishStatus(omronUpdateList *updates, int asynIndex, asynStatus status, int alarmSeverity)
+{
+  if (updates == NULL)
+  {
+    setParamStatus(asynIndex, status);
+    if (alarmSeverity >= 0)
     {
-      epicsInt8 data[sliceSize];
-      std::string dataString;
-      for (int i = 0; i < sliceSize; i++)
-      {
-        data[i] = plc_tag_get_int8(drvUser->tagIndex, (offset + i));
-        dataString += std::to_string(data[i]) + ' ';
-      }
-      if (sliceSize == 1)
-        status = setIntegerParam(asynIndex, data[0]);
-      else
-        status = doCallbacksInt8Array(data, sliceSize, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, dataString.c_str(), datatype.c_str());
+      setParamAlarmStatus(asynIndex, status);
+      setParamAlarmSeverity(asynIndex, alarmSeverity);
     }
-    else if (datatype == "INT")
+    return;
+  }
+  updates->push_back([this, asynIndex, status, alarmSeverity]() {
+    setParamStatus(asynIndex, status);
+    if (alarmSeverity >= 0)
     {
-      epicsInt16 data[sliceSize];
-      std::string dataString;
-      for (int i = 0; i < sliceSize; i++)
-      {
-        data[i] = plc_tag_get_int16(drvUser->tagIndex, (offset + i * 2));
-        dataString += std::to_string(data[i]) + ' ';
-      }
-      if (sliceSize == 1)
-        status = setIntegerParam(asynIndex, data[0]);
-      else
-        status = doCallbacksInt16Array(data, sliceSize, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, dataString.c_str(), datatype.c_str());
+      setParamAlarmStatus(asynIndex, status);
+      setParamAlarmSeverity(asynIndex, alarmSeverity);
     }
-    else if (datatype == "DINT")
+    return asynSuccess;
+  });
+}
+
+bool drvOmronEIP::withinDeadband(omronDrvUser_t *drvUser, double value)
+{
+  if (drvUser->deadband <= 0)
+    return false;
+  if (drvUser->lastPublishedValid)
+  {
+    double band = drvUser->deadbandPercent ? std::fabs(drvUser->lastPublished) * drvUser->deadband / 100 : drvUser->deadband;
+    if (std::fabs(value - drvUser->lastPublished) <= band)
+      return true;
+  }
+  drvUser->lastPublished = value;
+  drvUser->lastPublishedValid = true;
+  return false;
+}
+
+int drvOmronEIP::takeSnapshot(omronDrvUser_t *drvUser, std::vector<uint8_t> &bytes)
+{
+  omronCipType_t cipType = drvUser->cipType;
+  int tagSize = plc_tag_get_size(drvUser->tagIndex);
+  int start = drvUser->tagOffset;
+  int end = tagSize;
+  if (cipType == omronTypeBOOL)
+  {
+    // BOOL offsets are in bits, this covers both bit packed and byte packed arrays
+    start = drvUser->tagOffset / 8;
+    end = start + drvUser->sliceSize;
+  }
+  else if (cipType == omronTypeSTRING && !drvUser->optimise)
+  {
+    start = 0; // the offset is applied to the decoded string, so the whole tag is used
+  }
+  else if (drvUser->dataType.second != 0 && cipType != omronTypeWORD && cipType != omronTypeDWORD && cipType != omronTypeLWORD)
+  {
+    end = start + drvUser->dataType.second * drvUser->sliceSize;
+  }
+  end = std::min(end, tagSize);
+  if (start < 0 || start >= end)
+  {
+    // The decoders report that the snapshot is too short
+    bytes.clear();
+    return PLCTAG_STATUS_OK;
+  }
+  bytes.resize(end - start);
+  return plc_tag_get_raw_bytes(drvUser->tagIndex, start, bytes.data(), bytes.size());
+}
+
+epicsUInt32 drvOmronEIP::gatherBits(const uint8_t *bytes, int firstBit, int count)
+{
+  epicsInt8 bits[32];
+  epicsUInt32 word = 0;
+  unpackBits(bytes, firstBit, count, bits);
+  for (int i = 0; i < count; i++)
+    word |= (epicsUInt32)bits[i] << i;
+  return word;
+}
+
+bool drvOmronEIP::rawDataChanged(omronDrvUser_t *drvUser)
+{
+  // Only one poller thread decodes a given parameter, but different pollers may run at once so each thread has its own buffer
+  thread_local std::vector<uint8_t> rawBytes;
+  const std::vector<uint8_t> *bytes = &drvUser->snapshot;
+  if (drvUser->cipType == omronTypeSTRING)
+  {
+    if (takeSnapshot(drvUser, rawBytes) != PLCTAG_STATUS_OK)
+      return true;
+    bytes = &rawBytes;
+  }
+  if (bytes->empty())
+    return true; // let readData report the problem
+  if (drvUser->shadowValid && *bytes == drvUser->shadowBytes)
+    return false;
+  drvUser->shadowBytes.assign(bytes->begin(), bytes->end());
+  drvUser->shadowValid = true;
+  return true;
+}
+
+void drvOmronEIP::tagCallback(int32_t tagIndex, int event, int status)
+{
+  if (event != PLCTAG_EVENT_READ_COMPLETED && event != PLCTAG_EVENT_WRITE_COMPLETED && event != PLCTAG_EVENT_ABORTED)
+    return;
+  auto tagState = tagStates_.find(tagIndex);
+  if (tagState == tagStates_.end())
+    return;
+  if ((event == PLCTAG_EVENT_WRITE_COMPLETED || event == PLCTAG_EVENT_ABORTED) && tagState->second.writeInFlight)
+  {
+    // A read cannot be sent while a write is in flight, so an abort now is the abort of the write
+    std::vector<int> writeParams;
+    epicsMutexMustLock(writeLock_);
+    writeParams.swap(tagState->second.writeParams);
+    tagState->second.writeInFlight = false;
+    bool writesQueued = tagState->second.writeQueued;
+    epicsMutexUnlock(writeLock_);
+    if (writesQueued)
+      epicsEventSignal(flushWake_);
+    if (event == PLCTAG_EVENT_ABORTED)
+      status = PLCTAG_ERR_ABORT;
+    // The port lock is needed to update the parameters, we must not wait for it on libplctags thread
+    writeCompletions_->submit([this, tagIndex, status, writeParams]() { writeCompleted(tagIndex, status, writeParams); });
+    return;
+  }
+  if (event == PLCTAG_EVENT_WRITE_COMPLETED)
+    return;
+  if (event == PLCTAG_EVENT_READ_COMPLETED && status == PLCTAG_STATUS_OK)
+  {
+    // Record when the reply arrived so that the parameters decoded from it are stamped with this rather than the time of the callbacks
+    epicsTimeStamp now;
+    epicsTimeGetCurrent(&now);
+    tagState->second.replyTime = ((uint64_t)now.secPastEpoch << 32) | now.nsec;
+  }
+  omronEIPPoller *pReader = tagState->second.reader;
+  if (pReader != NULL && tagState->second.inFlight.exchange(false))
+  {
+    double roundTripTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - tagState->second.issueTime).count();
+    pReader->pacedReadFinished(roundTripTime, event == PLCTAG_EVENT_READ_COMPLETED && status == PLCTAG_STATUS_OK);
+    pReader->inFlight_--;
+  }
+  for (omronEIPPoller *pPoller : tagState->second.pollers)
+  {
+    epicsEventSignal(pPoller->readComplete_);
+  }
+  if (workerPool_ != NULL && !tagState->second.pollers.empty())
+    epicsEventSignal(schedulerWake_);
+}
+
+asynStatus drvOmronEIP::loadStructFile(const char *portName, const char *filePath)
+{
+  const char *functionName = "loadStructFile";
+  std::ifstream infile(filePath);
+  structDtypeMap structMap;
+  std::vector<std::string> row;
+  std::string line, word;
+  asynStatus status = asynSuccess;
+
+  if (infile.fail())
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Could not find file: %s. Either missing or invalid permissions.\n", driverName, functionName, filePath);
+    return asynError;
+  }
+
+  if (!structMap_.empty())
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Only one structure definition file can be loaded at once!\n", driverName, functionName);
+    return asynError;
+  }
+
+  while (std::getline(infile, line))
+  {
+    row.clear();
+    std::istringstream s(line);
+    while (std::getline(s, word, ','))
     {
-      epicsInt32 data[sliceSize];
-      std::string dataString;
-      for (int i = 0; i < sliceSize; i++)
-      {
-        data[i] = plc_tag_get_int32(drvUser->tagIndex, (offset + i * 4));
-        dataString += std::to_string(data[i]) + ' ';
-      }
-      if (sliceSize == 1)
-        status = setIntegerParam(asynIndex, data[0]);
-      else
-        status = doCallbacksInt32Array(data, sliceSize, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, dataString.c_str(), datatype.c_str());
+      if (word[0] == '#')
+        break;
+      row.push_back(word);
     }
-    else if (datatype == "LINT")
+    if (row.size() == 1)
     {
-      // We do not natively support reading arrays of Int64, these must be read as UDTs
-      epicsInt64 data;
-      data = plc_tag_get_int64(drvUser->tagIndex, offset);
-      status = setInteger64Param(asynIndex, data);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %lld My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, data, datatype.c_str());
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s structure: %s contains no valid members\n", driverName, functionName, row[0].c_str());
     }
-    else if (datatype == "USINT")
+    else if (!row.empty())
     {
-      epicsUInt8 data[sliceSize];
-      std::string dataString;
-      for (int i = 0; i < sliceSize; i++)
-      {
-        data[i] = plc_tag_get_uint8(drvUser->tagIndex, (offset + i));
-        dataString += std::to_string(data[i]) + ' ';
-      }
-      if (sliceSize == 1)
-        status = setIntegerParam(asynIndex, data[0]);
-      else
-        status = doCallbacksInt8Array((epicsInt8 *)data, sliceSize, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, dataString.c_str(), datatype.c_str());
+      std::string structName = row.front();
+      row.erase(row.begin());
+      structMap[structName] = row;
     }
-    else if (datatype == "UINT")
+  }
+
+  std::string flowString;
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Loading in struct file with the following definitions:\n", driverName, functionName);
+  for (auto const &i : structMap)
+  {
+    flowString += i.first + ": ";
+    for (auto const &j : i.second)
+      flowString += j + " ";
+    asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s\n", flowString.c_str());
+    flowString.clear();
+  }
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "\n");
+  status = this->utilities->createStructMap(structMap);
+  return status;
+}
+
+template <typename T, typename epicsType>
+asynStatus drvOmronEIP::decodeNumeric(omronDrvUser_t *drvUser, int asynIndex, omronUpdateList *updates,
+                                      asynStatus (asynPortDriver::*doCallbacks)(epicsType *, size_t, int, int))
+{
+  const char *functionName = "decodeNumeric";
+  asynStatus status = asynSuccess;
+  int sliceSize = drvUser->sliceSize;
+  // Each thread decodes one parameter at a time, so a buffer per thread and type is enough and polling does not allocate
+  thread_local std::vector<T> values;
+  values.resize(sliceSize);
+  T *data = values.data();
+  if (!snapshotValues<T>(drvUser, sliceSize, data))
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Attempting to read %d %s values beyond the end of the tag\n",
+              driverName, functionName, drvUser->tagIndex, sliceSize, drvUser->dataType.first.c_str());
+    return asynError;
+  }
+  if (sliceSize == 1)
+  {
+    if (!withinDeadband(drvUser, data[0]))
     {
-      // We read a uint and then must save it as an int to use the asyn Int16Array. The waveform record allows it to be displayed as uint
-      epicsUInt16 data[sliceSize];
-      std::string dataString;
-      for (int i = 0; i < sliceSize; i++)
-      {
-        data[i] = plc_tag_get_uint16(drvUser->tagIndex, (offset + i * 2));
-        dataString += std::to_string((uint16_t)data[i]) + ' ';
-      }
-      if (sliceSize == 1)
-        status = setIntegerParam(asynIndex, data[0]);
+      if (std::is_floating_point<T>::value)
+        status = publishDouble(updates, asynIndex, data[0]);
+      else if (sizeof(T) == sizeof(epicsInt64))
+        status = publishInteger64(updates, asynIndex, data[0]);
       else
-        status = doCallbacksInt16Array((epicsInt16 *)data, sliceSize, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, dataString.c_str(), datatype.c_str());
+        status = publishInteger(updates, asynIndex, data[0]);
     }
-    else if (datatype == "UDINT")
+  }
+  else
+  {
+    // Unsigned types are published through the signed array interface of the same size, the waveform record can display them as unsigned
+    status = publishArray(updates, doCallbacks, (epicsType *)data, sliceSize, asynIndex);
+  }
+  if (pasynTrace->getTraceMask(pasynUserSelf) & ASYN_TRACEIO_DRIVER)
+  {
+    std::stringstream ss;
+    for (int i = 0; i < sliceSize; i++)
     {
-      // We read a udint and then must save it as a dint to use the asyn Int32Array interface.
-      // The waveform record allows it to be displayed as udint
-      epicsUInt32 data[sliceSize];
-      std::string dataString;
-      for (int i = 0; i < sliceSize; i++)
+      ss << +data[i] << ' ';
+    }
+    asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
+              driverName, functionName, asynIndex, drvUser->tagIndex, ss.str().c_str(), drvUser->dataType.first.c_str());
+  }
+  return status;
+}
+
+void drvOmronEIP::readData(omronDrvUser_t *drvUser, int asynIndex, omronEIPPoller *pPoller, omronUpdateList *updates)
+{
+  const char *functionName = "extractFetchedData";
+  int status;
+  const char *datatype = drvUser->dataType.first.c_str();
+  int offset = drvUser->tagOffset;
+  int sliceSize = drvUser->sliceSize;
+  int still_pending = 1;
+  bool readFailed = false;
+  auto timeoutStartTime = std::chrono::steady_clock::now();
+  double timeoutTimeTaken = 0; // time that we have been waiting for the current read request to be answered
+  // libplctag has thread protection for single API calls. However thedfsdddre is potential that while we are reading a tag on this poller,
+  // from the plc, we can be simultaneously reading data from the tag in libplctag. This could lead to the data being read, being
+  // overwritten as it is read, therefor we must lock the tag while reading it.
+  status = plc_tag_lock(drvUser->tagIndex);
+  if (status != 0)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, while locking Tag index: %d libplctag reports: %s\n",
+              driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
+    return;
+  }
+  while (still_pending)
+  {
+    status = plc_tag_status(drvUser->tagIndex);
+    // It should be rare that data for the first tag has not arrived before the last tag is read
+    // Therefore this if statement will normally be skipped, or called once by the first few tags as we
+    // are asynchronously waiting for all tags in this poller to be read.
+    if (status == PLCTAG_STATUS_PENDING)
+    {
+      timeoutTimeTaken = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeoutStartTime).count(); // seconds
+      if (timeoutTimeTaken < drvUser->timeout && pPoller == NULL && updates == NULL)
       {
-        data[i] = plc_tag_get_uint32(drvUser->tagIndex, (offset + i * 4));
-        dataString += std::to_string((uint32_t)data[i]) + ' ';
+        // There is no poller to signal us (initial read from drvUserCreate), we wait so that we dont spam libplctag with 
+        // status requests which can cause 100ms freezes. Pollers have already waited in waitForRead()
+        epicsThreadSleep(0.01);
       }
-      if (sliceSize == 1)
-        status = setIntegerParam(asynIndex, data[0]);
       else
-        status = doCallbacksInt32Array((epicsInt32 *)data, sliceSize, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, dataString.c_str(), datatype.c_str());
+      {
+        // If the timeout specified in the records INP/OUT field is hit, we set the status to asynTimeout
+        // To be precise, this is the timeout to enter this loop is the time between the last read request for this poller being sent and the current time,
+        // this means that the first read requests will have slightly longer than their timeout period for their data to return.
+        publishStatus(updates, asynIndex, asynTimeout, MAJOR_ALARM);
+        readFailed = true;
+        asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Timeout finishing read tag %d: %s. Decrease the polling rate or increase the timeout.\n",
+                  driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
+        still_pending = 0;
+      }
     }
-    else if (datatype == "ULINT")
+    else if (status < 0)
+    {
+      publishStatus(updates, asynIndex, asynError, MAJOR_ALARM);
+      readFailed = true;
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, finishing read of tag %d: %s\n",
+                driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
+      still_pending = 0;
+    }
+    else
     {
-      epicsUInt64 data;
-      data = plc_tag_get_uint64(drvUser->tagIndex, offset);
-      status = setInteger64Param(asynIndex, data);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %llu My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, data, datatype.c_str());
+      still_pending = 0;
+    }
+  }
+
+  bool locked = true;
+  if (!readFailed && drvUser->cipType != omronTypeSTRING)
+  {
+    // Copy the bytes which this parameter is decoded from and unlock the tag straight away, so that libplctag and any writes to the
+    // same tag are not held up while we decode and publish. STRING parameters are still decoded by libplctag while the tag is locked
+    status = takeSnapshot(drvUser, drvUser->snapshot);
+    plc_tag_unlock(drvUser->tagIndex);
+    locked = false;
+    if (status != PLCTAG_STATUS_OK)
+    {
+      publishStatus(updates, asynIndex, asynError, MAJOR_ALARM);
+      readFailed = true;
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while copying tag data: %s\n",
+                driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
     }
-    else if (datatype == "REAL")
+  }
+
+  if (readFailed)
+  {
+    // Make sure that the parameter is updated again once the tag can be read
+    drvUser->shadowValid = false;
+    drvUser->lastPublishedValid = false;
+  }
+  else if (drvUser->publishOnChange && !rawDataChanged(drvUser))
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d Data unchanged, skipping update\n",
+              driverName, functionName, asynIndex, drvUser->tagIndex);
+    if (locked)
+      plc_tag_unlock(drvUser->tagIndex);
+    return;
+  }
+
+  if (!readFailed)
+  {
+    switch (drvUser->cipType)
     {
-      epicsFloat32 data[sliceSize];
-      std::string dataString;
-      std::stringstream ss;
-      for (int i = 0; i < sliceSize; i++)
+    case omronTypeBOOL:
+    {
+      // The snapshot starts at the byte which holds the first bit
+      const uint8_t *bytes = drvUser->snapshot.data();
+      int bit = offset % 8;
+      epicsUInt32 dataOut = 0;
+      if (sliceSize > 32)
+      {
+        // Too many bools for a UInt32Digital, we publish them as a bitmap waveform with one element per bool
+        size_t needed = drvUser->optimise ? (bit + sliceSize + 7) / 8 : sliceSize;
+        if (drvUser->snapshot.size() < needed)
+        {
+          asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Attempting to read BOOL data beyond the end of the tag\n",
+                    driverName, functionName, drvUser->tagIndex);
+          status = asynError;
+          break;
+        }
+        drvUser->readBuffer.resize(sliceSize);
+        epicsInt8 *bitmap = (epicsInt8 *)drvUser->readBuffer.data();
+        if (drvUser->optimise)
+          unpackBits(bytes, bit, sliceSize, bitmap);
+        else
+          unpackBoolBytes(bytes, bit, sliceSize, bitmap);
+        status = publishArray(updates, &asynPortDriver::doCallbacksInt8Array, bitmap, sliceSize, asynIndex);
+        if (pasynTrace->getTraceMask(pasynUserSelf) & ASYN_TRACEIO_DRIVER)
+        {
+          std::string printData(sliceSize, '0');
+          for (int i = 0; i < sliceSize; i++)
+            printData[i] += bitmap[i];
+          asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
+                    driverName, functionName, asynIndex, drvUser->tagIndex, printData.c_str(), datatype);
+        }
+        break;
+      }
+      else if (drvUser->snapshot.size() < (size_t)(sliceSize == 1 || drvUser->optimise ? (bit + sliceSize + 7) / 8 : sliceSize))
+      {
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Attempting to read BOOL data beyond the end of the tag\n",
+                  driverName, functionName, drvUser->tagIndex);
+        status = asynError;
+        break;
+      }
+      if (sliceSize == 1 || drvUser->optimise)
       {
-        data[i] = plc_tag_get_float32(drvUser->tagIndex, (offset + i * 4));
-        ss << data[i] << ' ';
+        // A single bool, or bools from an embedded array where they are packed at the bit level (1byte=8bools), starting at bit
+        dataOut = gatherBits(bytes, bit, sliceSize);
       }
-      dataString = ss.str();
-      if (sliceSize == 1)
-        status = setDoubleParam(asynIndex, data[0]);
       else
-        status = doCallbacksFloat32Array(data, sliceSize, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, dataString.c_str(), datatype.c_str());
-    }
-    else if (datatype == "LREAL")
-    {
-      epicsFloat64 data[sliceSize];
-      std::string dataString;
-      std::stringstream ss;
-      for (int i = 0; i < sliceSize; i++)
       {
-        data[i] = plc_tag_get_float64(drvUser->tagIndex, (offset + i * 8));
-        ss << data[i] << ' ';
+        // We are getting bools from a regular bool array where they are packed at the byte level (1byte=1bool)
+        for (int i =0;i<sliceSize;i++){
+          dataOut |= (epicsUInt32)((bytes[i] >> bit) & 1) << i;
+        }
+      }
+      status = publishUIntDigital(updates, asynIndex, dataOut, 0xFFFFFFFF, 0xFFFFFFFF);
+      if (pasynTrace->getTraceMask(pasynUserSelf) & ASYN_TRACEIO_DRIVER)
+      {
+        std::string printData = std::bitset<32>(dataOut).to_string();
+        asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
+                  driverName, functionName, asynIndex, drvUser->tagIndex, printData.c_str(), datatype);
       }
-      dataString = ss.str();
-      if (sliceSize == 1)
-        status = setDoubleParam(asynIndex, data[0]);
-      else
-        status = doCallbacksFloat64Array(data, sliceSize, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, dataString.c_str(), datatype.c_str());
+      break;
     }
-    else if (datatype == "STRING")
+    case omronTypeSINT:
+      status = decodeNumeric<epicsInt8>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksInt8Array);
+      break;
+    case omronTypeINT:
+      status = decodeNumeric<epicsInt16>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksInt16Array);
+      break;
+    case omronTypeDINT:
+      status = decodeNumeric<epicsInt32>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksInt32Array);
+      break;
+    case omronTypeLINT:
+      status = decodeNumeric<epicsInt64>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksInt64Array);
+      break;
+    case omronTypeUSINT:
+      status = decodeNumeric<epicsUInt8>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksInt8Array);
+      break;
+    case omronTypeUINT:
+      status = decodeNumeric<epicsUInt16>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksInt16Array);
+      break;
+    case omronTypeUDINT:
+      status = decodeNumeric<epicsUInt32>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksInt32Array);
+      break;
+    case omronTypeULINT:
+      status = decodeNumeric<epicsUInt64>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksInt64Array);
+      break;
+    case omronTypeREAL:
+      status = decodeNumeric<epicsFloat32>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksFloat32Array);
+      break;
+    case omronTypeLREAL:
+      status = decodeNumeric<epicsFloat64>(drvUser, asynIndex, updates, &asynPortDriver::doCallbacksFloat64Array);
+      break;
+    case omronTypeSTRING:
     {
       int bufferSize = plc_tag_get_size(drvUser->tagIndex);
       int string_length;
@@ -1166,15 +1958,18 @@ void drvOmronEIP::readData(omronDrvUser_t *drvUser, int asynIndex)
       {
         asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, attempting to read at an offset beyond tag buffer!\n",
                   driverName, functionName);
-        return;
+        status = asynError;
+        break;
       }
       else if (string_length > string_capacity + 1)
       {
         asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, offset does not point to valid string! Did you set the string size? Is offsetReadSize > str_max_capacity? My asyn parameter ID: %d My tagIndex: %d\n",
                   driverName, functionName, asynIndex, drvUser->tagIndex);
-        return;
+        status = asynError;
+        break;
       }
-      char *pData = (char *)malloc((size_t)(unsigned int)(string_length));
+      drvUser->readBuffer.resize(string_length);
+      char *pData = (char *)drvUser->readBuffer.data();
       if (drvUser->optimise)
       {
         status = plc_tag_get_string(drvUser->tagIndex, offset, pData, string_length);
@@ -1187,15 +1982,16 @@ void drvOmronEIP::readData(omronDrvUser_t *drvUser, int asynIndex)
       {
         asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while accessing STRING data: %s\n",
                   driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-        return;
+        status = asynError;
+        break;
       }
 
       if (drvUser->optimise)
       {
         // for optimise case, we already accounted for the offset when getting the data from libplctag
-        status = setStringParam(asynIndex, pData);
+        status = publishString(updates, asynIndex, pData);
         asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                  driverName, functionName, asynIndex, drvUser->tagIndex, pData, datatype.c_str());
+                  driverName, functionName, asynIndex, drvUser->tagIndex, pData, datatype);
       }
       else
       {
@@ -1213,18 +2009,20 @@ void drvOmronEIP::readData(omronDrvUser_t *drvUser, int asynIndex)
           asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, the string length < offset+offset_read_size. Printing the entire string instead. Are the str attributes correct?\n",
                     driverName, functionName);
 
-        status = setStringParam(asynIndex, correctedString.c_str());
+        status = publishString(updates, asynIndex, correctedString.c_str());
         asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %s My type %s\n",
-                  driverName, functionName, asynIndex, drvUser->tagIndex, correctedString.c_str(), datatype.c_str());
+                  driverName, functionName, asynIndex, drvUser->tagIndex, correctedString.c_str(), datatype);
       }
-      free(pData);
+      break;
     }
-
-    else if (datatype == "WORD")
+    case omronTypeWORD:
+    case omronTypeDWORD:
+    case omronTypeLWORD:
     {
-      int bytes = 2;
+      int bytes = drvUser->dataType.second;
       int tagSize = plc_tag_get_size(drvUser->tagIndex);
       int size = bytes * sliceSize;
+      int elements = sliceSize;
       if (size + offset <= tagSize)
       {
         size = tagSize - offset; // read all data after offset
@@ -1232,296 +2030,949 @@ void drvOmronEIP::readData(omronDrvUser_t *drvUser, int asynIndex)
       else
       {
         size = 0;
+        elements = 0;
         asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Tag index: %d You are attempting to read beyond the end of the buffer, output has been truncated\n",
                   driverName, functionName, drvUser->tagIndex);
       }
-      uint8_t *rawData = (uint8_t *)malloc((size_t)(uint8_t)size);
-      status = plc_tag_get_raw_bytes(drvUser->tagIndex, offset, rawData, size);
-      if (status != 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while accessing WORD data: %s\n",
-                  driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-        return;
-      }
-      epicsInt8 *pData = (epicsInt8 *)malloc(size * sizeof(epicsInt8));
-      /* We flip around the hex numbers to match what is done in the PLC */
-      int n;
-      char hexString[size * 2 + 1]{};
-      for (int i = 0; i < sliceSize; i++)
+      // The snapshot runs from the offset to the end of the tag
+      uint8_t *wordData = drvUser->snapshot.data();
+      size = std::min(size, (int)drvUser->snapshot.size());
+      /* We flip around the hex numbers of the requested elements to match what is done in the PLC */
+      reverseElements(wordData, std::min(elements, size / bytes), bytes);
+      status = publishArray(updates, &asynPortDriver::doCallbacksInt8Array, (epicsInt8 *)wordData, size, asynIndex);
+      if (pasynTrace->getTraceMask(pasynUserSelf) & ASYN_TRACEIO_DRIVER)
       {
-        n = bytes - 1;
-        for (int j = 0; j < bytes; j++)
-        {
-          sprintf(hexString + strlen(hexString), "%02X", rawData[n + i * bytes]);
-          pData[j + i * bytes] = rawData[n + i * bytes];
-          n--;
-        }
+        asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: 0x%s My type %s\n",
+                  driverName, functionName, asynIndex, drvUser->tagIndex, toHex(wordData, size).c_str(), datatype);
       }
-      status = doCallbacksInt8Array(pData, size, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: 0x%s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, hexString, datatype.c_str());
-      free(rawData);
-      free(pData);
+      break;
     }
-    else if (datatype == "DWORD")
+    case omronTypeUDT:
     {
-      int bytes = 4;
+      int bytes = 0;
       int tagSize = plc_tag_get_size(drvUser->tagIndex);
-      int size = bytes * sliceSize;
-      if (size + offset <= tagSize)
+      if (drvUser->offsetReadSize != 0)
       {
-        size = tagSize - offset; // read all data after offset
+        bytes = drvUser->offsetReadSize; // user may request a byte size rather than reading the entire UDT
+      }
+      if (bytes + offset <= tagSize)
+      {
+        bytes = tagSize - offset; // read all data after offset
       }
       else
       {
-        size = 0;
+        bytes = 0;
         asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Tag index: %d You are attempting to read beyond the end of the buffer, output has been truncated\n",
                   driverName, functionName, drvUser->tagIndex);
       }
-      uint8_t *rawData = (uint8_t *)malloc((size_t)(uint8_t)size);
-      status = plc_tag_get_raw_bytes(drvUser->tagIndex, offset, rawData, size);
-      if (status != 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while accessing DWORD data: %s\n",
-                  driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-        return;
-      }
-      epicsInt8 *pData = (epicsInt8 *)malloc(size * sizeof(epicsInt8));
-      /* We flip around the hex numbers to match what is done in the PLC */
-      int n;
-      char hexString[size * 2 + 1]{};
-      for (int i = 0; i < sliceSize; i++)
+      // The snapshot runs from the offset to the end of the tag
+      uint8_t *rawData = drvUser->snapshot.data();
+      status = publishArray(updates, &asynPortDriver::doCallbacksInt8Array, (epicsInt8 *)rawData, bytes, asynIndex);
+      if (pasynTrace->getTraceMask(pasynUserSelf) & ASYN_TRACEIO_DRIVER)
       {
-        n = bytes - 1;
-        for (int j = 0; j < bytes; j++)
-        {
-          sprintf(hexString + strlen(hexString), "%02X", rawData[n + i * bytes]);
-          pData[j + i * bytes] = rawData[n + i * bytes];
-          n--;
-        }
+        asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: 0x%s My type: %s\n",
+                  driverName, functionName, asynIndex, drvUser->tagIndex, toHex(rawData, bytes).c_str(), datatype);
       }
-      status = doCallbacksInt8Array(pData, size, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: 0x%s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, hexString, datatype.c_str());
-      free(rawData);
-      free(pData);
+      break;
     }
-    else if (datatype == "LWORD")
+    case omronTypeTIME:
     {
-      int bytes = 8;
-      int tagSize = plc_tag_get_size(drvUser->tagIndex);
-      int size = bytes * sliceSize;
-      if (size + offset <= tagSize)
+      epicsInt64 data;
+      if (!snapshotValues<epicsInt64>(drvUser, 1, &data))
       {
-        size = tagSize - offset; // read all data after offset
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Attempting to read TIME data beyond the end of the tag\n",
+                  driverName, functionName, drvUser->tagIndex);
+        status = asynError;
+        break;
+      }
+      // readAsString is what made drvUserCreate() create an octet parameter, we use it so that we dont need the parameter list here
+      if (drvUser->readAsString)
+      {
+        // first we modify the incoming time by the timezone offset defined at driver creation
+        // then we convert from this timezone to the local timezone and output as a formatted string
+        data += timezoneOffset_ * -3.6e12; // offset in hours * number of nanoseconds in an hour
+        char buff[32];
+        drvUser->timeFormatter.format(data, drvUser->timeDecimals, buff);
+
+        status = publishString(updates, asynIndex, buff);
+
+        asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My raw data: %lld My converted data: %s My type %s\n",
+                  driverName, functionName, asynIndex, drvUser->tagIndex, data, buff, datatype);
       }
       else
       {
-        size = 0;
-        asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Tag index: %d You are attempting to read beyond the end of the buffer, output has been truncated\n",
-                  driverName, functionName, drvUser->tagIndex);
+        status = publishInteger64(updates, asynIndex, data);
+        asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %lld My type %s\n",
+                  driverName, functionName, asynIndex, drvUser->tagIndex, data, datatype);
       }
-      uint8_t *rawData = (uint8_t *)malloc((size_t)(uint8_t)size);
-      status = plc_tag_get_raw_bytes(drvUser->tagIndex, offset, rawData, size);
-      if (status != 0)
+      break;
+    }
+    }
+    publishStatus(updates, asynIndex, (asynStatus)status);
+  }
+
+  if (status != asynSuccess)
+  {
+    drvUser->shadowValid = false;
+    drvUser->lastPublishedValid = false;
+  }
+  if (status == asynError)
+  {
+    publishStatus(updates, asynIndex, asynError);
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err occured while updating asyn parameter with asyn ID: %d tagIndex: %d Datatype %s\n",
+              driverName, functionName, asynIndex, drvUser->tagIndex, datatype);
+  }
+  else if (status == asynTimeout)
+  {
+    publishStatus(updates, asynIndex, asynTimeout);
+    asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Timeout occured while updating asyn parameter with asyn ID: %d tagIndex: %d Datatype %s\n",
+              driverName, functionName, asynIndex, drvUser->tagIndex, datatype);
+  }
+  else if (status == asynSuccess)
+  {
+    publishStatus(updates, asynIndex, asynSuccess, NO_ALARM);
+  }
+  if (locked)
+  {
+    status = plc_tag_unlock(drvUser->tagIndex);
+    if (status != 0)
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while trying to unlock tag: %s\n",
+                driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
+    }
+  }
+  return;
+}
+
+void drvOmronEIP::readPoller()
+{
+  static const char *functionName = "readPoller";
+  std::string threadName = epicsThreadGetNameSelf();
+  // The poller may not be fully initialised until the startPollers_ flag is set to 1, do not attempt to get the pPoller yet
+  while (!this->startPollers_ && !omronExiting)
+  {
+    epicsThreadSleep(0.1);
+  }
+  omronEIPPoller *pPoller = pollerList_.at(threadName);
+  if (omronExiting)
+  {
+    epicsEventSignal(pPoller->threadExited_);
+    return;
+  }
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Starting poller: %s with interval: %f\n", driverName, functionName, threadName.c_str(), pPoller->updateRate_);
+  pPoller->startSchedule(std::chrono::steady_clock::now());
+  while (!omronExiting)
+  {
+    // Sleep until the absolute deadline of this cycle. epicsThreadSleep may return early, so we check the clock again each time
+    double waitTime = std::chrono::duration<double>(pPoller->nextDeadline_ - std::chrono::steady_clock::now()).count();
+    while (waitTime > 0 && !omronExiting)
+    {
+      epicsThreadSleep(waitTime);
+      waitTime = std::chrono::duration<double>(pPoller->nextDeadline_ - std::chrono::steady_clock::now()).count();
+    }
+    if (omronExiting) { break; }
+    pPoller->cycleStartTime_ = std::chrono::steady_clock::now();
+    issueReads(pPoller);
+    processReads(pPoller);
+  }
+  epicsEventSignal(pPoller->threadExited_);
+}
+
+void drvOmronEIP::schedulerLoop()
+{
+  static const char *functionName = "schedulerLoop";
+  std::vector<omronEIPPoller*> duePollers;
+  std::vector<omronEIPPoller*> waitingPollers; // Pollers whose requests have been sent and which are waiting for their replies
+  while (!this->startPollers_ && !omronExiting)
+  {
+    epicsThreadSleep(0.1);
+  }
+  if (omronExiting)
+  {
+    epicsEventSignal(schedulerExited_);
+    return;
+  }
+
+  // All pollers share the same phase reference so that pollers with related rates send their requests in the same burst
+  auto now = std::chrono::steady_clock::now();
+  int pacedPollers = 0;
+  epicsMutexMustLock(schedulerLock_);
+  for (auto poller : pollerList_)
+  {
+    poller.second->startSchedule(now);
+    schedulerQueue_.push_back(poller.second);
+    std::push_heap(schedulerQueue_.begin(), schedulerQueue_.end(), laterDeadline);
+    pacedPollers += (poller.second->spreadRequests_ || poller.second->maxInFlight_ > 0 || bandwidth_ != NULL);
+  }
+  epicsMutexUnlock(schedulerLock_);
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Starting scheduler for %zu pollers with %d worker threads\n", 
+              driverName, functionName, pollerList_.size(), workerPool_->threadCount_);
+  if (pacedPollers >= workerPool_->threadCount_)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, %d pollers pace their requests and hold a worker while sending them. Use at least %d worker threads so that decoding is not held up.\n",
+              driverName, functionName, pacedPollers, pacedPollers + 1);
+  }
+
+  while (!omronExiting)
+  {
+    double waitTime = 1.0; // wake up regularly even if all pollers are busy, so that we notice omronExiting
+    now = std::chrono::steady_clock::now();
+    epicsMutexMustLock(schedulerLock_);
+    while (!schedulerQueue_.empty() && schedulerQueue_.front()->nextDeadline_ <= now)
+    {
+      std::pop_heap(schedulerQueue_.begin(), schedulerQueue_.end(), laterDeadline);
+      duePollers.push_back(schedulerQueue_.back());
+      schedulerQueue_.pop_back();
+    }
+    if (!schedulerQueue_.empty())
+    {
+      waitTime = std::min(waitTime, std::chrono::duration<double>(schedulerQueue_.front()->nextDeadline_ - now).count());
+    }
+    waitingPollers.insert(waitingPollers.end(), sentPollers_.begin(), sentPollers_.end());
+    sentPollers_.clear();
+    epicsMutexUnlock(schedulerLock_);
+
+    // Send the requests of every due poller together. Pollers which spread their requests or wait for a window or the bandwidth
+    // budget do this on a worker instead so they dont hold up the scheduler, and hand themselves back once their requests are sent
+    for (omronEIPPoller *pPoller : duePollers)
+    {
+      pPoller->cycleStartTime_ = now;
+      if (!pPoller->spreadRequests_ && pPoller->maxInFlight_ == 0 && bandwidth_ == NULL)
       {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while accessing LWORD data: %s\n",
-                  driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-        return;
+        issueReads(pPoller);
+        pPoller->readsSentTime_ = std::chrono::steady_clock::now();
+        waitingPollers.push_back(pPoller);
+        continue;
       }
-      epicsInt8 *pData = (epicsInt8 *)malloc(size * sizeof(epicsInt8));
-      /* We flip around the hex numbers to match what is done in the PLC */
-      int n;
-      char hexString[size * 2 + 1]{};
-      for (int i = 0; i < sliceSize; i++)
+      workerPool_->submit([this, pPoller]() {
+        issueReads(pPoller);
+        pPoller->readsSentTime_ = std::chrono::steady_clock::now();
+        epicsMutexMustLock(schedulerLock_);
+        sentPollers_.push_back(pPoller);
+        epicsMutexUnlock(schedulerLock_);
+        epicsEventSignal(schedulerWake_);
+      });
+    }
+    duePollers.clear();
+
+    // The workers only decode, the waiting for the PLC is done here. tagCallback() wakes us each time one of the reads completes
+    for (auto it = waitingPollers.begin(); it != waitingPollers.end();)
+    {
+      omronEIPPoller *pPoller = *it;
+      if (!repliesArrived(pPoller, waitTime))
+      {
+        ++it;
+        continue;
+      }
+      it = waitingPollers.erase(it);
+      workerPool_->submit([this, pPoller]() {
+        processReads(pPoller);
+        epicsMutexMustLock(schedulerLock_);
+        schedulerQueue_.push_back(pPoller);
+        std::push_heap(schedulerQueue_.begin(), schedulerQueue_.end(), laterDeadline);
+        epicsMutexUnlock(schedulerLock_);
+        epicsEventSignal(schedulerWake_);
+      });
+    }
+    epicsEventWaitWithTimeout(schedulerWake_, waitTime);
+  }
+  epicsEventSignal(schedulerExited_);
+}
+
+bool drvOmronEIP::repliesArrived(omronEIPPoller *pPoller, double &waitTime)
+{
+  const std::vector<omronPollEntry_t> &decodeList = pPoller->decodeList_;
+  double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - pPoller->readsSentTime_).count();
+  for (; pPoller->repliesChecked_ < decodeList.size(); pPoller->repliesChecked_++)
+  {
+    size_t i = pPoller->repliesChecked_;
+    omronDrvUser_t *drvUser = decodeList[i].drvUser;
+    // Parameters sharing a tag are next to each other in the decodeList_, so each tag is only checked once
+    if (i > 0 && decodeList[i - 1].drvUser->tagIndex == drvUser->tagIndex)
+      continue;
+    if (!decodeDue(pPoller, drvUser) || plc_tag_status(drvUser->tagIndex) != PLCTAG_STATUS_PENDING)
+      continue;
+    if (waited < drvUser->timeout)
+    {
+      waitTime = std::min(waitTime, drvUser->timeout - waited);
+      return false;
+    }
+    // readData() reports the timeout
+  }
+  pPoller->repliesChecked_ = 0;
+  return true;
+}
+
+/** Adds the number of records subscribed to each asyn parameter through one of the asyn interfaces to subscribers */
+template <typename interruptType>
+static void countSubscribers(void *interruptPvt, std::unordered_map<int, int> &subscribers)
+{
+  ELLLIST *pclientList;
+  if (interruptPvt == NULL || pasynManager->interruptStart(interruptPvt, &pclientList) != asynSuccess)
+    return;
+  interruptNode *pnode = (interruptNode *)ellFirst(pclientList);
+  while (pnode)
+  {
+    interruptType *pInterrupt = (interruptType *)pnode->drvPvt;
+    subscribers[pInterrupt->pasynUser->reason]++;
+    pnode = (interruptNode *)ellNext(&pnode->node);
+  }
+  pasynManager->interruptEnd(interruptPvt);
+}
+
+void drvOmronEIP::refreshDemand()
+{
+  static const char *functionName = "refreshDemand";
+  epicsMutexMustLock(demandLock_);
+  auto now = std::chrono::steady_clock::now();
+  if (std::chrono::duration<double>(now - lastDemandRefresh_).count() < 1.0)
+  {
+    epicsMutexUnlock(demandLock_);
+    return;
+  }
+  lastDemandRefresh_ = now;
+  std::unordered_map<int, int> subscribers;
+  countSubscribers<asynInt32Interrupt>(asynStdInterfaces.int32InterruptPvt, subscribers);
+  countSubscribers<asynInt64Interrupt>(asynStdInterfaces.int64InterruptPvt, subscribers);
+  countSubscribers<asynUInt32DigitalInterrupt>(asynStdInterfaces.uInt32DigitalInterruptPvt, subscribers);
+  countSubscribers<asynFloat64Interrupt>(asynStdInterfaces.float64InterruptPvt, subscribers);
+  countSubscribers<asynOctetInterrupt>(asynStdInterfaces.octetInterruptPvt, subscribers);
+  countSubscribers<asynInt8ArrayInterrupt>(asynStdInterfaces.int8ArrayInterruptPvt, subscribers);
+  countSubscribers<asynInt16ArrayInterrupt>(asynStdInterfaces.int16ArrayInterruptPvt, subscribers);
+  countSubscribers<asynInt32ArrayInterrupt>(asynStdInterfaces.int32ArrayInterruptPvt, subscribers);
+  countSubscribers<asynInt64ArrayInterrupt>(asynStdInterfaces.int64ArrayInterruptPvt, subscribers);
+  countSubscribers<asynFloat32ArrayInterrupt>(asynStdInterfaces.float32ArrayInterruptPvt, subscribers);
+  countSubscribers<asynFloat64ArrayInterrupt>(asynStdInterfaces.float64ArrayInterruptPvt, subscribers);
+
+  // A tag is needed if any parameter decoded from it has a subscriber. Optimised parameters share the tag of their master, so the 
+  // master keeps being read for as long as any of the parameters it feeds are subscribed to, whichever poller they belong to
+  std::unordered_map<int32_t, bool> demanded;
+  for (auto poller : pollerList_)
+  {
+    for (const omronPollEntry_t &entry : poller.second->decodeList_)
+    {
+      bool &tagDemanded = demanded[entry.drvUser->tagIndex];
+      auto it = subscribers.find(entry.asynIndex);
+      tagDemanded = tagDemanded || (it != subscribers.end() && it->second > 0);
+    }
+  }
+  for (auto &tagState : tagStates_)
+  {
+    bool isDemanded = demanded[tagState.first];
+    if (tagState.second.demanded.exchange(isDemanded) != isDemanded)
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Tag index: %d is %s\n", driverName, functionName, tagState.first,
+                  isDemanded ? "subscribed to, resuming reads" : "no longer subscribed to, pausing reads");
+    }
+  }
+  epicsMutexUnlock(demandLock_);
+}
+
+bool drvOmronEIP::tagDemanded(const omronEIPPoller *pPoller, const omronDrvUser_t *drvUser)
+{
+  if (!pPoller->onDemand_)
+    return true;
+  auto tagState = tagStates_.find(drvUser->tagIndex);
+  return (tagState == tagStates_.end() || tagState->second.demanded);
+}
+
+bool drvOmronEIP::tagDue(const omronEIPPoller *pPoller, const omronDrvUser_t *drvUser)
+{
+  if (!tagDemanded(pPoller, drvUser))
+    return false;
+  auto tagState = tagStates_.find(drvUser->tagIndex);
+  // Parameters which share a tag read by a different poller are decoded every cycle, as they would be without poll_every
+  if (tagState == tagStates_.end() || tagState->second.reader != pPoller || tagState->second.pollEvery <= 1)
+    return true;
+  return (pPoller->readCycle_ % tagState->second.pollEvery == tagState->second.pollPhase);
+}
+
+bool drvOmronEIP::admitRead(omronEIPPoller *pPoller, int32_t tagIndex)
+{
+  static const char *functionName = "admitRead";
+  if (bandwidth_ == NULL)
+    return true;
+  auto tagState = tagStates_.find(tagIndex);
+  // A request which cannot be sent before the next cycle is due is skipped, so that low priority pollers fall behind gracefully 
+  // rather than sending an ever growing backlog. nextDeadline_ is still the deadline of the current cycle until processReads() 
+  // moves it on, so the next deadline is measured from the start of this cycle
+  auto nextDeadline = pPoller->cycleStartTime_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                     std::chrono::duration<double>(pPoller->updateRate_));
+  double timeout = std::chrono::duration<double>(nextDeadline - std::chrono::steady_clock::now()).count();
+  if (bandwidth_->acquire(pPoller->priority_, pPoller->updateRate_, plc_tag_get_size(tagIndex), timeout))
+  {
+    if (tagState != tagStates_.end())
+      tagState->second.budgetSkipped = false;
+    return true;
+  }
+  if (tagState != tagStates_.end())
+    tagState->second.budgetSkipped = true;
+  pPoller->budgetSkips_++;
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Poller: %s skipped reading tag: %d, the bandwidth budget is used up\n", 
+              driverName, functionName, pPoller->pollerName_, tagIndex);
+  return false;
+}
+
+bool drvOmronEIP::decodeDue(const omronEIPPoller *pPoller, const omronDrvUser_t *drvUser)
+{
+  if (!tagDue(pPoller, drvUser))
+    return false;
+  auto tagState = tagStates_.find(drvUser->tagIndex);
+  return (tagState == tagStates_.end() || (!tagState->second.budgetSkipped && !tagState->second.writeSkipped));
+}
+
+void drvOmronEIP::issueReads(omronEIPPoller *pPoller)
+{
+  static const char *functionName = "issueReads";
+  double interval = pPoller->updateRate_;
+  double pollingDelay = 0; // To stop from overloading the PLC, we divide read requests throughout the polling interval
+  if (pPoller->onDemand_)
+    refreshDemand();
+  pPoller->readCycle_++;
+  for (const omronPollEntry_t &entry : pPoller->readList_)
+  {
+    if (!tagDue(pPoller, entry.drvUser) || !readAllowed(entry.drvUser->tagIndex))
+      continue;
+    if (pPoller->spreadRequests_ == 2 || pPoller->maxInFlight_ > 0)
+    {
+      issuePacedRead(pPoller, entry.drvUser->tagIndex);
+      continue;
+    }
+    if (!admitRead(pPoller, entry.drvUser->tagIndex))
+      continue;
+    asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Reading tag: %d with polling interval: %f seconds\n", 
+                driverName, functionName, entry.drvUser->tagIndex, interval);
+    sendRead(entry.drvUser->tagIndex); // Send read request to plc, we will check status and timeouts later
+    /* If spreadRequests is true, we sleep to split up read requests within timing interval, otherwise we can get traffic jams and missed 
+       polling intervals */
+    if (pPoller->myTagCount_ > 1 && pPoller->spreadRequests_)
+    {
+      pollingDelay = (interval - 0.2 * interval) / pPoller->myTagCount_;
+      epicsThreadSleep(pollingDelay);
+      if (omronExiting)
+        break;
+    }
+  }
+}
+
+void drvOmronEIP::issuePacedRead(omronEIPPoller *pPoller, int32_t tagIndex)
+{
+  static const char *functionName = "issuePacedRead";
+  const double minWait = 0.01;
+  double targetInFlight, rttEstimate;
+  int limit;
+  bool waited = false;
+  omronTagState_t &tagState = tagStates_.at(tagIndex);
+  if (tagState.inFlight)
+  {
+    // The reply to the previous request for this tag has not arrived, libplctag would reject a second request
+    return;
+  }
+  auto waitStart = std::chrono::steady_clock::now();
+  while (true)
+  {
+    if (omronExiting)
+      return;
+    epicsMutexMustLock(pPoller->pacingLock_);
+    targetInFlight = pPoller->targetInFlight_;
+    rttEstimate = pPoller->rttEstimate_;
+    epicsMutexUnlock(pPoller->pacingLock_);
+    if (pPoller->spreadRequests_ == 2)
+      limit = (pPoller->maxInFlight_ > 0) ? std::min((int)targetInFlight, pPoller->maxInFlight_) : (int)targetInFlight;
+    else
+      limit = pPoller->maxInFlight_;
+    if (pPoller->inFlight_ < limit)
+      break;
+    waited = true;
+    if (epicsEventWaitWithTimeout(pPoller->readComplete_, std::max(minWait, 4 * rttEstimate)) != epicsEventWaitTimeout)
+      continue;
+    if (pPoller->spreadRequests_ == 2)
+    {
+      // No reply within a few round trips, the PLC is struggling so we reduce the target and keep waiting
+      asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Poller: %s timed out waiting for a reply with %d requests in flight\n", 
+                  driverName, functionName, pPoller->pollerName_, (int)pPoller->inFlight_);
+      pPoller->pacedReadFinished(0, false);
+    }
+    if (std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStart).count() > pPoller->updateRate_)
+    {
+      // The window must not stall the poller forever if the PLC drops a reply, the tag is read again in the next cycle
+      asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Poller: %s waited longer than its interval for the window to open, tag: %d deferred to the next cycle\n", 
+                  driverName, functionName, pPoller->pollerName_, tagIndex);
+      pPoller->windowSkips_++;
+      return;
+    }
+  }
+
+  if (!admitRead(pPoller, tagIndex))
+    return;
+  pPoller->windowRequests_++;
+  pPoller->windowOccupancySum_ += pPoller->inFlight_;
+  if (waited)
+    pPoller->windowFullCount_++;
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Reading tag: %d with %d requests in flight, target: %f, round trip time: %f ms\n", 
+              driverName, functionName, tagIndex, (int)pPoller->inFlight_, targetInFlight, rttEstimate * 1E3);
+  tagState.issueTime = std::chrono::steady_clock::now();
+  pPoller->inFlight_++;
+  tagState.inFlight = true;
+  int status = sendRead(tagIndex);
+  if (status != PLCTAG_STATUS_PENDING && status != PLCTAG_STATUS_OK && tagState.inFlight.exchange(false))
+  {
+    // The request was never sent so there will be no reply
+    pPoller->inFlight_--;
+  }
+}
+
+void drvOmronEIP::waitForRead(omronEIPPoller *pPoller, omronDrvUser_t *drvUser, std::chrono::steady_clock::time_point waitStartTime)
+{
+  while (decodeDue(pPoller, drvUser) && plc_tag_status(drvUser->tagIndex) == PLCTAG_STATUS_PENDING)
+  {
+    double timeTaken = std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStartTime).count();
+    if (timeTaken >= drvUser->timeout)
+      break; // readData() reports the timeout
+    // Block until tagCallback() tells us that one of this pollers reads has finished, then check the status again. 
+    // The event may have been signalled by a different tag, in which case we just wait again.
+    epicsEventWaitWithTimeout(pPoller->readComplete_, drvUser->timeout - timeTaken);
+  }
+}
+
+epicsTimeStamp drvOmronEIP::tagTimeStamp(int32_t tagIndex)
+{
+  epicsTimeStamp stamp;
+  auto tagState = tagStates_.find(tagIndex);
+  if (tagState == tagStates_.end())
+  {
+    epicsTimeGetCurrent(&stamp);
+    return stamp;
+  }
+  omronDrvUser_t *source = tagState->second.timestampSource;
+  if (source != NULL && plc_tag_status(tagIndex) == PLCTAG_STATUS_OK)
+  {
+    // The PLC TIME is nanoseconds since 1970 in the PLCs timezone, the same as is done when TIME is read as a string
+    int64_t plcTime = plc_tag_get_int64(tagIndex, source->tagOffset) + (int64_t)(timezoneOffset_ * -3.6e12);
+    int64_t secs = plcTime / 1000000000 - POSIX_TIME_AT_EPICS_EPOCH;
+    if (plcTime > 0 && secs >= 0 && secs <= UINT32_MAX)
+    {
+      stamp.secPastEpoch = (epicsUInt32)secs;
+      stamp.nsec = (epicsUInt32)(plcTime % 1000000000);
+      return stamp;
+    }
+  }
+  uint64_t replyTime = tagState->second.replyTime;
+  if (replyTime == 0)
+  {
+    epicsTimeGetCurrent(&stamp);
+    return stamp;
+  }
+  stamp.secPastEpoch = (epicsUInt32)(replyTime >> 32);
+  stamp.nsec = (epicsUInt32)(replyTime & 0xFFFFFFFF);
+  return stamp;
+}
+
+asynStatus drvOmronEIP::publishTimeStamp(omronUpdateList *updates, const epicsTimeStamp &stamp)
+{
+  if (updates == NULL)
+  {
+    asynStatus status = callParamCallbacks();
+    setTimeStamp(&stamp);
+    return status;
+  }
+  updates->push_back([this, stamp]() {
+    asynStatus status = callParamCallbacks();
+    setTimeStamp(&stamp);
+    return status;
+  });
+  return asynSuccess;
+}
+
+void drvOmronEIP::decodeInParallel(omronEIPPoller *pPoller)
+{
+  static const char *functionName = "decodeInParallel";
+  int status;
+  // Wait for every read to finish here, so that the decode workers never block waiting for the PLC. In scheduler mode the scheduler
+  // has already waited for them
+  auto waitStartTime = (workerPool_ != NULL) ? pPoller->readsSentTime_ : std::chrono::steady_clock::now();
+  for (const omronPollEntry_t &entry : pPoller->readList_)
+  {
+    waitForRead(pPoller, entry.drvUser, waitStartTime);
+  }
+
+  size_t entries = pPoller->decodeList_.size();
+  size_t chunks = (entries + decodeChunkSize_ - 1) / decodeChunkSize_;
+  std::vector<omronUpdateList> updates(chunks);
+  std::atomic<size_t> remaining(chunks);
+  for (size_t chunk = 0; chunk < chunks; chunk++)
+  {
+    decodePool_->submit([this, pPoller, chunk, entries, &updates, &remaining]() {
+      size_t last = std::min(entries, (chunk + 1) * decodeChunkSize_);
+      int32_t stampedTag = 0;
+      for (size_t i = chunk * decodeChunkSize_; i < last; i++)
       {
-        n = bytes - 1;
-        for (int j = 0; j < bytes; j++)
+        const omronPollEntry_t &entry = pPoller->decodeList_[i];
+        if (!decodeDue(pPoller, entry.drvUser))
+          continue;
+        // Parameters sharing a tag are next to each other in the decodeList_, so we only change the timestamp when the tag changes
+        if (entry.drvUser->tagIndex != stampedTag)
         {
-          sprintf(hexString + strlen(hexString), "%02X", rawData[n + i * bytes]);
-          pData[j + i * bytes] = rawData[n + i * bytes];
-          n--;
+          stampedTag = entry.drvUser->tagIndex;
+          publishTimeStamp(&updates[chunk], tagTimeStamp(stampedTag));
         }
+        readData(entry.drvUser, entry.asynIndex, pPoller, &updates[chunk]);
       }
-      status = doCallbacksInt8Array(pData, size, asynIndex, 0);
-      asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: 0x%s My type %s\n",
-                driverName, functionName, asynIndex, drvUser->tagIndex, hexString, datatype.c_str());
-      free(rawData);
-      free(pData);
+      if (--remaining == 0)
+        epicsEventSignal(pPoller->decodeDone_);
+    });
+  }
+  while (remaining > 0)
+  {
+    epicsEventWaitWithTimeout(pPoller->decodeDone_, 1.0);
+  }
+
+  // Apply the updates in the same order as the decodeList_ and then do all of the callbacks together
+  this->lock();
+  for (omronUpdateList &chunkUpdates : updates)
+  {
+    for (std::function<asynStatus()> &update : chunkUpdates)
+    {
+      update();
     }
-    else if (datatype == "UDT")
+  }
+  status = callParamCallbacks();
+  // The port timestamp is left at the reply time of the last tag, other callbacks must not be stamped with it
+  updateTimeStamp();
+  this->unlock();
+  if (status != asynSuccess)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, while performing asyn callbacks on read poller: %s\n", driverName, functionName, pPoller->pollerName_);
+  }
+}
+
+void drvOmronEIP::processReads(omronEIPPoller *pPoller)
+{
+  static const char *functionName = "processReads";
+  int status;
+  if (decodePool_ != NULL && pPoller->decodeList_.size() > decodeChunkSize_)
+  {
+    decodeInParallel(pPoller);
+  }
+  else
+  {
+    // The port timestamp is shared by all pollers, so each tag is decoded and its callbacks done under the port lock, after which
+    // the timestamp is put back to the current time for callbacks made outside the pollers. The lock is not held while we wait for the PLC
+    int32_t stampedTag = 0;
+    epicsTimeStamp stamp;
+    status = asynSuccess;
+    for (const omronPollEntry_t &entry : pPoller->decodeList_)
     {
-      int bytes = 0;
-      int tagSize = plc_tag_get_size(drvUser->tagIndex);
-      if (drvUser->offsetReadSize != 0)
-      {
-        bytes = drvUser->offsetReadSize; // user may request a byte size rather than reading the entire UDT
-      }
-      if (bytes + offset <= tagSize)
-      {
-        bytes = tagSize - offset; // read all data after offset
-      }
-      else
-      {
-        bytes = 0;
-        asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Tag index: %d You are attempting to read beyond the end of the buffer, output has been truncated\n",
-                  driverName, functionName, drvUser->tagIndex);
-      }
-      uint8_t *rawData = (uint8_t *)malloc(bytes * sizeof(uint8_t));
-      status = plc_tag_get_raw_bytes(drvUser->tagIndex, offset, rawData, bytes);
-      if (status != 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while accessing UDT data: %s\n",
-                  driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
-        return;
-      }
-      epicsInt8 *pData = (epicsInt8 *)malloc(bytes * sizeof(epicsInt8));
-      memcpy(pData, rawData, bytes);
-      status = doCallbacksInt8Array(pData, bytes, asynIndex, 0);
-      if (pasynTrace->getTraceMask(pasynUserSelf) & ASYN_TRACEIO_DRIVER)
+      if (!decodeDue(pPoller, entry.drvUser))
+        continue;
+      if (entry.drvUser->tagIndex != stampedTag)
       {
-        char hexString[bytes * 2 + 1]{};
-        for (int i = 0; i < bytes; i++)
+        if (stampedTag != 0)
         {
-          sprintf(hexString + strlen(hexString), "%02X", rawData[i]);
+          if (callParamCallbacks() != asynSuccess)
+            status = asynError;
+          updateTimeStamp();
+          this->unlock();
         }
-        asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: 0x%s My type: %s\n",
-                  driverName, functionName, asynIndex, drvUser->tagIndex, hexString, datatype.c_str());
+        // Each read is given its full timeout from when we start to wait for it. In scheduler mode the scheduler has already waited
+        // for the reads, so this returns straight away
+        waitForRead(pPoller, entry.drvUser, (workerPool_ != NULL) ? pPoller->readsSentTime_ : std::chrono::steady_clock::now());
+        stampedTag = entry.drvUser->tagIndex;
+        stamp = tagTimeStamp(stampedTag);
+        this->lock();
+        setTimeStamp(&stamp);
       }
-
-      free(rawData);
-      free(pData);
+      readData(entry.drvUser, entry.asynIndex, pPoller);
     }
-    else if (datatype == "TIME")
+    if (stampedTag != 0)
     {
-      epicsInt64 data;
-      data = plc_tag_get_int64(drvUser->tagIndex, offset);
-      if (myParam == asynParamOctet)
-      {
-        // first we modify the incoming time by the timezone offset defined at driver creation
-        // then we convert from this timezone to the local timezone and output as a formatted string
-        data += timezoneOffset_ * -3.6e12; // offset in hours * number of nanoseconds in an hour
-        char buff[128];
-        std::chrono::duration<int64_t, std::nano> dur(data);
-        auto tp = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(dur));
-        std::time_t in_time_t = std::chrono::system_clock::to_time_t(tp);
-        strftime(buff, 128, "%Y-%m-%d %H:%M:%S", localtime(&in_time_t));
-        std::string resDate(buff);
-
-        status = setStringParam(asynIndex, resDate.c_str());
+      if (callParamCallbacks() != asynSuccess)
+        status = asynError;
+      updateTimeStamp();
+      this->unlock();
+    }
+    if (status != asynSuccess)
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, while performing asyn callbacks on read poller: %s\n", driverName, functionName, pPoller->pollerName_);
+    }
+  }
+  auto endTime = std::chrono::steady_clock::now();
+  pPoller->lastCycleTime_ = std::chrono::duration<double>(endTime - pPoller->cycleStartTime_).count();
+  pPoller->maxCycleTime_ = std::max(pPoller->maxCycleTime_, pPoller->lastCycleTime_);
+  pPoller->cycleCount_++;
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Poller: %s finished processing in: %d msec\n\n", driverName, functionName, pPoller->pollerName_, (int)(pPoller->lastCycleTime_ * 1E3));
+  if (pPoller->scheduleNextCycle(endTime))
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Reads taking longer than requested! %f > %f\n", driverName, functionName, pPoller->lastCycleTime_, pPoller->updateRate_);
+  }
+}
 
-        asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My raw data: %lld My converted data: %s My type %s\n",
-                  driverName, functionName, asynIndex, drvUser->tagIndex, data, resDate.c_str(), datatype.c_str());
-      }
-      else
-      {
-        status = setInteger64Param(asynIndex, data);
-        asynPrint(pasynUserSelf, ASYN_TRACEIO_DRIVER, "%s:%s My asyn parameter ID: %d My tagIndex: %d My data: %lld My type %s\n",
-                  driverName, functionName, asynIndex, drvUser->tagIndex, data, datatype.c_str());
-      }
+asynStatus drvOmronEIP::sendWrite(asynUser *pasynUser, omronDrvUser_t *drvUser, const char *functionName)
+{
+  int32_t tagIndex = drvUser->tagIndex;
+  int status;
+  auto tagState = tagStates_.end();
+  // Writes made before the callbacks are registered, from PINI records for example, wait for the reply as normal
+  if (asyncWrites_ && startPollers_)
+    tagState = tagStates_.find(tagIndex);
+  if (tagState == tagStates_.end())
+  {
+    status = plc_tag_write(tagIndex, pasynUser->timeout * 1000);
+    if (status < 0)
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
+      return asynError;
     }
-    setParamStatus(asynIndex, (asynStatus)status);
+    return asynSuccess;
   }
 
-  if (status == asynError)
+  // libplctag refuses a write while the last one is in flight. The values are copied into the request when it is sent, so rather
+  // than wait here with the port locked, we queue this write and writeFlusher() sends it when the last one finishes. Writes 
+  // which are already queued are sent together with this one
+  omronTagState_t &state = tagState->second;
+  if (coalesceWindow_ > 0 || state.writeInFlight || state.writeQueued)
   {
-    setParamStatus(asynIndex, asynError);
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err occured while updating asyn parameter with asyn ID: %d tagIndex: %d Datatype %s\n",
-              driverName, functionName, asynIndex, drvUser->tagIndex, datatype.c_str());
+    status = queueWrite(pasynUser, tagIndex, functionName);
+    // The asyn port thread makes every write, so while a record waited for the window no other write could join it
+    if (status != asynSuccess || coalesceWindow_ > 0)
+      return (asynStatus)status;
+    return waitForWrite(pasynUser, tagIndex, functionName);
   }
-  else if (status == asynTimeout)
+  // A read which is in flight is reported as an error by plc_tag_write, the same as a synchronous write, as its reply would 
+  // overwrite the values which we have just set. The write must be marked as in flight before it is sent, as the reply may arrive
+  // before plc_tag_write returns
+  epicsMutexMustLock(writeLock_);
+  state.writeInFlight = true;
+  state.writeSentTime = std::chrono::steady_clock::now();
+  state.writeParams.push_back(pasynUser->reason);
+  state.writesSent++;
+  epicsMutexUnlock(writeLock_);
+  status = plc_tag_write(tagIndex, 0);
+  if (status == PLCTAG_STATUS_PENDING || status == PLCTAG_STATUS_OK)
   {
-    setParamStatus(asynIndex, asynTimeout);
-    asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Timeout occured while updating asyn parameter with asyn ID: %d tagIndex: %d Datatype %s\n",
-              driverName, functionName, asynIndex, drvUser->tagIndex, datatype.c_str());
+    asyncWritesSent_++;
+    return waitForWrite(pasynUser, tagIndex, functionName);
   }
-  else if (status == asynSuccess)
+  // The write was not sent so there will be no callback for it
+  epicsMutexMustLock(writeLock_);
+  state.writeInFlight = false;
+  state.writeParams.clear();
+  state.writesSent--;
+  epicsMutexUnlock(writeLock_);
+  asyncWritesFailed_++;
+  asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
+  return asynError;
+}
+
+asynStatus drvOmronEIP::waitForWrite(asynUser *pasynUser, int32_t tagIndex, const char *functionName)
+{
+  omronTagState_t &state = tagStates_.at(tagIndex);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                        std::chrono::duration<double>(pasynUser->timeout));
+  bool finished = false;
+  int writeStatus = PLCTAG_STATUS_OK;
+  // writeCompleted() and writeFlusher() need the port lock to finish the write, and the pollers keep decoding while we wait
+  this->unlock();
+  while (!omronExiting)
   {
-    setParamStatus(asynIndex, asynSuccess);
-    setParamAlarmStatus(asynIndex, asynSuccess);
-    setParamAlarmSeverity(asynIndex, NO_ALARM);
+    epicsMutexMustLock(writeLock_);
+    finished = !state.writeQueued && state.writesDone == state.writesSent;
+    writeStatus = state.lastWriteStatus;
+    epicsMutexUnlock(writeLock_);
+    double remaining = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now()).count();
+    if (finished || remaining <= 0)
+      break;
+    epicsEventWaitWithTimeout(writeDone_, remaining);
   }
-  status = plc_tag_unlock(drvUser->tagIndex);
-  if (status != 0)
+  this->lock();
+  if (!finished)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d Error occured in libplctag while trying to unlock tag: %s\n",
-              driverName, functionName, drvUser->tagIndex, plc_tag_decode_error(status));
+    // tagCallback() reports the abort and writeCompleted() sets the alarm of the parameters which were written
+    if (state.writeInFlight)
+      plc_tag_abort(tagIndex);
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Timed out waiting for the PLC to reply to the write of tag index: %d\n", 
+              driverName, functionName, tagIndex);
+    return asynTimeout;
   }
-  return;
+  // writeCompleted() has already reported the error
+  if (writeStatus != PLCTAG_STATUS_OK)
+    return asynError;
+  return asynSuccess;
 }
 
-void drvOmronEIP::readPoller()
+asynStatus drvOmronEIP::queueWrite(asynUser *pasynUser, int32_t tagIndex, const char *functionName)
 {
-  static const char *functionName = "readPoller";
-  std::string threadName = epicsThreadGetNameSelf();
-  std::string tag;
-  int status;
-  int timeTaken = 0;
-  double pollingDelay = 0; // To stop from overloading the PLC, we divide read requests throughout the polling interval
-  // The poller may not be fully initialised until the startPollers_ flag is set to 1, do not attempt to get the pPoller yet
-  while (!this->startPollers_ && !omronExiting)
+  omronTagState_t &state = tagStates_.at(tagIndex);
+  // Pollers do not send new reads of the tag once writeQueued is set, but a read which is already in flight would overwrite the 
+  // values which we have just set, so we report an error as a synchronous write would. sendRead() checks writeQueued and sends 
+  // the read under writeLock_, so either it sees the write or we see its read. The write overrides hold the port lock, so only
+  // writeFlusher() can change the queue while we are here
+  epicsMutexMustLock(writeLock_);
+  bool firstWrite = !state.writeQueued;
+  if (firstWrite && !state.writeInFlight && plc_tag_status(tagIndex) == PLCTAG_STATUS_PENDING)
   {
-    epicsThreadSleep(0.1);
+    epicsMutexUnlock(writeLock_);
+    asyncWritesFailed_++;
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Tag index: %d is being read, the write was not sent\n", driverName, functionName, tagIndex);
+    return asynError;
   }
-  if (omronExiting) { return; }
-  omronEIPPoller *pPoller = pollerList_.at(threadName);
-  double interval = pPoller->updateRate_;
-  for (auto x : tagMap_)
+  state.writeQueued = true;
+  if (firstWrite)
+  {
+    state.flushTime = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                           std::chrono::duration<double>(coalesceWindow_));
+    state.queuedTimeout = 0;
+    queuedTags_.push_back(tagIndex);
+  }
+  else
+  {
+    coalescedWrites_++;
+  }
+  if (std::find(state.queuedParams.begin(), state.queuedParams.end(), pasynUser->reason) == state.queuedParams.end())
+    state.queuedParams.push_back(pasynUser->reason);
+  state.queuedTimeout = std::max(state.queuedTimeout, pasynUser->timeout);
+  epicsMutexUnlock(writeLock_);
+  if (firstWrite)
+    epicsEventSignal(flushWake_);
+  return asynSuccess;
+}
+
+void drvOmronEIP::flushWrites(int32_t tagIndex)
+{
+  omronTagState_t &state = tagStates_.at(tagIndex);
+  auto now = std::chrono::steady_clock::now();
+  if (state.writeInFlight)
+  {
+    // writeFlusher() only calls us while the last write is in flight once it has waited longer than the records timeout for its 
+    // reply. We abort it and tagCallback() reports it as failed and wakes writeFlusher() to send the queued writes. If the abort is
+    // not reported we try again after another timeout
+    epicsMutexMustLock(writeLock_);
+    state.writeSentTime = now;
+    epicsMutexUnlock(writeLock_);
+    plc_tag_abort(tagIndex);
+    return;
+  }
+  epicsMutexMustLock(writeLock_);
+  state.writeParams.swap(state.queuedParams);
+  state.queuedParams.clear();
+  queuedTags_.erase(std::remove(queuedTags_.begin(), queuedTags_.end(), tagIndex), queuedTags_.end());
+  state.writeInFlight = true;
+  state.writeSentTime = now;
+  state.writesSent++;
+  epicsMutexUnlock(writeLock_);
+  int status = plc_tag_write(tagIndex, 0);
+  // Pollers may read the tag again once the write has been sent, a read sent while the write is in flight is refused by libplctag
+  epicsMutexMustLock(writeLock_);
+  state.writeQueued = false;
+  epicsMutexUnlock(writeLock_);
+  if (status == PLCTAG_STATUS_PENDING || status == PLCTAG_STATUS_OK)
   {
-    if (x.second->pollerName == threadName && x.second->readFlag == true)
-      pPoller->myTagCount_ += 1;
+    asyncWritesSent_++;
+    return;
   }
-  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Starting poller: %s with interval: %f\n", driverName, functionName, threadName.c_str(), interval);
-  auto startTime = std::chrono::system_clock::now();
+  // The write was not sent so there will be no callback for it
+  std::vector<int> writeParams;
+  epicsMutexMustLock(writeLock_);
+  state.writeInFlight = false;
+  writeParams.swap(state.writeParams);
+  epicsMutexUnlock(writeLock_);
+  writeCompleted(tagIndex, status, writeParams);
+}
+
+void drvOmronEIP::writeFlusher()
+{
+  std::vector<int32_t> dueTags;
   while (!omronExiting)
   {
-    startTime = std::chrono::system_clock::now();
-    double waitTime = interval - ((double)timeTaken / 1E9);
-    if (waitTime >= 0)
+    double waitTime = 1.0; // wake up regularly even if no writes are queued, so that we notice omronExiting
+    auto now = std::chrono::steady_clock::now();
+    epicsMutexMustLock(writeLock_);
+    for (int32_t tagIndex : queuedTags_)
     {
-      epicsThreadSleep(waitTime);
+      const omronTagState_t &state = tagStates_.at(tagIndex);
+      double untilDue = std::chrono::duration<double>(state.flushTime - now).count();
+      // Writes queued behind a write in flight are sent when tagCallback() wakes us to say that it has finished, or once it has
+      // taken longer than the timeout, in which case flushWrites() aborts it
+      if (state.writeInFlight)
+        untilDue = std::max(untilDue, state.queuedTimeout - std::chrono::duration<double>(now - state.writeSentTime).count());
+      if (untilDue <= 0)
+        dueTags.push_back(tagIndex);
+      else
+        waitTime = std::min(waitTime, untilDue);
     }
-    else
+    epicsMutexUnlock(writeLock_);
+    if (dueTags.empty())
     {
-      waitTime = 0;
-      asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, Reads taking longer than requested! %f > %f\n", driverName, functionName, ((double)timeTaken / 1E9), interval);
+      epicsEventWaitWithTimeout(flushWake_, waitTime);
+      continue;
     }
-
-    for (auto x : tagMap_)
+    // The port lock stops the write overrides from changing the tag buffers while they are sent
+    this->lock();
+    for (int32_t tagIndex : dueTags)
     {
-      if (x.second->pollerName == threadName && x.second->readFlag == true)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Reading tag: %d with polling interval: %f seconds\n", 
-                    driverName, functionName, x.second->tagIndex, interval);
-        plc_tag_read(x.second->tagIndex, 0); // Send read request to plc, we will check status and timeouts later
-        /* If spreadRequests is true, we sleep to split up read requests within timing interval, otherwise we can get traffic jams and missed 
-           polling intervals */
-        if (pPoller->myTagCount_ > 1 && pPoller->spreadRequests_)
-        {
-          pollingDelay = (interval - 0.2 * interval) / pPoller->myTagCount_;
-          epicsThreadSleep(pollingDelay);
-        }
-      }
+      flushWrites(tagIndex);
     }
+    this->unlock();
+    dueTags.clear();
+  }
+  epicsEventSignal(writeFlusherExited_);
+}
 
-    for (auto x : tagMap_)
-    {
-      if (x.second->pollerName == threadName)
-      {
-        readData(x.second, x.first);
-      }
-    }
+bool drvOmronEIP::readAllowed(int32_t tagIndex)
+{
+  if (!asyncWrites_)
+    return true;
+  auto tagState = tagStates_.find(tagIndex);
+  if (tagState == tagStates_.end())
+    return true;
+  bool queued = tagState->second.writeQueued;
+  tagState->second.writeSkipped = queued;
+  return !queued;
+}
 
-    status = callParamCallbacks();
-    if (status != asynSuccess)
-    {
-      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, while performing asyn callbacks on read poller: %s\n", driverName, functionName, threadName.c_str());
-    }
-    auto endTime = std::chrono::system_clock::now();
-    timeTaken = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count() - waitTime * 1E9;
-    if (timeTaken > 0)
-      asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Poller: %s finished processing in: %d msec\n\n", driverName, functionName, threadName.c_str(), (int)(timeTaken / 1E6));
+int drvOmronEIP::sendRead(int32_t tagIndex)
+{
+  auto tagState = tagStates_.find(tagIndex);
+  if (!asyncWrites_ || tagState == tagStates_.end())
+    return plc_tag_read(tagIndex, 0);
+  // A write may have been queued since readAllowed(), queueWrite() checks for a read in flight under writeLock_ so the check and
+  // the read must happen together
+  epicsMutexMustLock(writeLock_);
+  bool queued = tagState->second.writeQueued;
+  tagState->second.writeSkipped = queued;
+  int status = queued ? PLCTAG_ERR_BUSY : plc_tag_read(tagIndex, 0);
+  epicsMutexUnlock(writeLock_);
+  return status;
+}
+
+void drvOmronEIP::writeCompleted(int32_t tagIndex, int status, const std::vector<int> &writeParams)
+{
+  static const char *functionName = "writeCompleted";
+  if (status != PLCTAG_STATUS_OK)
+  {
+    asyncWritesFailed_++;
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Asynchronous write of tag index: %d failed: %s\n", 
+              driverName, functionName, tagIndex, plc_tag_decode_error(status));
+  }
+  this->lock();
+  for (int asynIndex : writeParams)
+  {
+    if (status == PLCTAG_STATUS_OK)
+      publishStatus(NULL, asynIndex, asynSuccess, NO_ALARM);
+    else
+      publishStatus(NULL, asynIndex, asynError, MAJOR_ALARM);
   }
+  // The port timestamp is left at the reply time of whichever tag a poller decoded last, so stamp the write results with now
+  updateTimeStamp();
+  callParamCallbacks();
+  this->unlock();
+  // Wake the write override which is waiting for this write, after the parameters so that its readbacks are already up to date
+  omronTagState_t &state = tagStates_.at(tagIndex);
+  epicsMutexMustLock(writeLock_);
+  state.lastWriteStatus = status;
+  state.writesDone++;
+  epicsMutexUnlock(writeLock_);
+  epicsEventSignal(writeDone_);
 }
 
 asynStatus drvOmronEIP::writeInt8Array(asynUser *pasynUser, epicsInt8 *value, size_t nElements)
@@ -1530,11 +2981,9 @@ asynStatus drvOmronEIP::writeInt8Array(asynUser *pasynUser, epicsInt8 *value, si
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   size_t offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
   size_t sliceSize = drvUser->sliceSize;
   int status = 0;
   size_t tagSize = plc_tag_get_size(tagIndex);
-  double timeout = pasynUser->timeout * 1000;
   bool writeOutOfBounds = 0;
   if (nElements > tagSize)
   {
@@ -1543,14 +2992,15 @@ asynStatus drvOmronEIP::writeInt8Array(asynUser *pasynUser, epicsInt8 *value, si
               driverName, functionName, tagIndex, nElements, tagSize);
     return asynError;
   }
-  else if (nElements < sliceSize)
+  else if (nElements < sliceSize && drvUser->cipType != omronTypeBOOL)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, with libplctag tag index: %d. Request to write less values than the configured sliceSize, missing data will be written as null. nElements<sliceSize:  %ld < %ld.\n",
               driverName, functionName, tagIndex, nElements, sliceSize);
   }
-  if (datatype == "UDT")
+  if (drvUser->cipType == omronTypeUDT)
   {
-    uint8_t *pOutput = (uint8_t *)malloc(tagSize * sizeof(uint8_t));
+    drvUser->writeBuffer.resize(tagSize);
+    uint8_t *pOutput = drvUser->writeBuffer.data();
     // Copy data to UDT, any values which are not defined, are written as 0
     for (size_t i = 0; i < tagSize; i++)
     {
@@ -1574,30 +3024,11 @@ asynStatus drvOmronEIP::writeInt8Array(asynUser *pasynUser, epicsInt8 *value, si
       asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
       return asynError;
     }
-    status = plc_tag_write(tagIndex, timeout);
-    if (status < 0)
-    {
-      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-      return asynError;
-    }
-    free(pOutput);
-    return asynSuccess;
+    return sendWrite(pasynUser, drvUser, functionName);
   }
-  else if (datatype == "WORD" || datatype == "DWORD" || datatype == "LWORD")
+  else if (drvUser->cipType == omronTypeWORD || drvUser->cipType == omronTypeDWORD || drvUser->cipType == omronTypeLWORD)
   {
-    size_t bytes = 0;
-    if (datatype == "WORD")
-    {
-      bytes = 2;
-    }
-    else if (datatype == "DWORD")
-    {
-      bytes = 4;
-    }
-    else if (datatype == "LWORD")
-    {
-      bytes = 8;
-    }
+    size_t bytes = drvUser->dataType.second;
 
     if (nElements + offset > sliceSize * bytes)
     {
@@ -1611,7 +3042,8 @@ asynStatus drvOmronEIP::writeInt8Array(asynUser *pasynUser, epicsInt8 *value, si
                 driverName, functionName, tagIndex, nElements, sliceSize * bytes);
     }
 
-    uint8_t *pOutput = (uint8_t *)malloc(sliceSize * bytes * sizeof(uint8_t));
+    drvUser->writeBuffer.assign(sliceSize * bytes + offset, 0);
+    uint8_t *pOutput = drvUser->writeBuffer.data();
     int n;
     for (size_t i = 0; i < sliceSize; i++)
     {
@@ -1637,64 +3069,51 @@ asynStatus drvOmronEIP::writeInt8Array(asynUser *pasynUser, epicsInt8 *value, si
       asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
       return asynError;
     }
-    status = plc_tag_write(tagIndex, timeout);
-    if (status < 0)
+    return sendWrite(pasynUser, drvUser, functionName);
+  }
+  else if (drvUser->cipType == omronTypeBOOL)
+  {
+    // Bitmap write, element i sets bool i. Bools beyond nElements are not changed, so a short waveform only writes the start of the array
+    if (nElements > sliceSize)
     {
-      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, with libplctag tag index: %d. Request to write more bools than the configured sliceSize! nElements>sliceSize:  %ld > %ld.\n",
+                driverName, functionName, tagIndex, nElements, sliceSize);
       return asynError;
     }
-    free(pOutput);
-    return asynSuccess;
-  }
-  else if (datatype == "SINT")
-  {
-    for (size_t i = 0; i < sliceSize; i++)
+    for (size_t i = 0; i < nElements; i++)
     {
-      /* If nElements is less than sliceSize, the remaining data is written as zeroes */
-      if (nElements <= i)
-        status = plc_tag_set_int8(tagIndex, offset + i, 0);
-      else
-        status = plc_tag_set_int8(tagIndex, offset + i, *(value + i));
+      status = plc_tag_set_bit(tagIndex, boolBitOffset(drvUser, i), value[i] != 0);
       if (status < 0)
       {
         asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
         return asynError;
       }
     }
-    status = plc_tag_write(tagIndex, timeout);
+    return sendWrite(pasynUser, drvUser, functionName);
+  }
+  else if (drvUser->cipType == omronTypeSINT)
+  {
+    status = encodeNumeric<epicsInt8>(tagIndex, offset, value, nElements, sliceSize);
     if (status < 0)
     {
       asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
       return asynError;
     }
-    return asynSuccess;
+    return sendWrite(pasynUser, drvUser, functionName);
   }
-  else if (datatype == "USINT")
+  else if (drvUser->cipType == omronTypeUSINT)
   {
-    for (size_t i = 0; i < sliceSize; i++)
-    {
-      /* If nElements is less than sliceSize, the remaining data is written as zeroes */
-      if (nElements <= i)
-        status = plc_tag_set_uint8(tagIndex, offset + i, 0);
-      else
-        status = plc_tag_set_uint8(tagIndex, offset + i, *(value + i));
-      if (status < 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-        return asynError;
-      }
-    }
-    status = plc_tag_write(tagIndex, timeout);
+    status = encodeNumeric<epicsUInt8>(tagIndex, offset, value, nElements, sliceSize);
     if (status < 0)
     {
       asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
       return asynError;
     }
-    return asynSuccess;
+    return sendWrite(pasynUser, drvUser, functionName);
   }
   else
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
 }
@@ -1705,10 +3124,8 @@ asynStatus drvOmronEIP::writeInt16Array(asynUser *pasynUser, epicsInt16 *value,
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
   size_t sliceSize = drvUser->sliceSize;
   int status = 0;
-  double timeout = pasynUser->timeout * 1000;
   if (nElements > sliceSize)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, with libplctag tag index: %d. Request to write more values than the configured sliceSize! nElements>sliceSize:  %ld > %ld.\n",
@@ -1721,51 +3138,25 @@ asynStatus drvOmronEIP::writeInt16Array(asynUser *pasynUser, epicsInt16 *value,
               driverName, functionName, tagIndex, nElements, sliceSize);
   }
 
-  if (datatype == "INT")
-  {
-    for (size_t i = 0; i < sliceSize; i++)
-    {
-      /* If nElements is less than sliceSize, the remaining data is written as zeroes */
-      if (nElements <= i)
-        status = plc_tag_set_int16(tagIndex, offset + i * 2, 0);
-      else
-        status = plc_tag_set_int16(tagIndex, offset + i * 2, *(value + i));
-      if (status < 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-        return asynError;
-      }
-    }
-  }
-  else if (datatype == "UINT")
-  {
-    for (size_t i = 0; i < sliceSize; i++)
-    {
-      /* If nElements is less than sliceSize, the remaining data is written as zeroes */
-      if (nElements <= i)
-        status = plc_tag_set_uint16(tagIndex, offset + i * 2, 0);
-      else
-        status = plc_tag_set_uint16(tagIndex, offset + i * 2, *(value + i));
-      if (status < 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-        return asynError;
-      }
-    }
-  }
-  else
+  switch (drvUser->cipType)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+  case omronTypeINT:
+    status = encodeNumeric<epicsInt16>(tagIndex, offset, value, nElements, sliceSize);
+    break;
+  case omronTypeUINT:
+    status = encodeNumeric<epicsUInt16>(tagIndex, offset, value, nElements, sliceSize);
+    break;
+  default:
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
-
-  status = plc_tag_write(tagIndex, timeout);
   if (status < 0)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
     return asynError;
   }
-  return asynSuccess;
+
+  return sendWrite(pasynUser, drvUser, functionName);
 }
 
 asynStatus drvOmronEIP::writeInt32Array(asynUser *pasynUser, epicsInt32 *value, size_t nElements)
@@ -1774,10 +3165,8 @@ asynStatus drvOmronEIP::writeInt32Array(asynUser *pasynUser, epicsInt32 *value,
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
   size_t sliceSize = drvUser->sliceSize;
   int status = 0;
-  double timeout = pasynUser->timeout * 1000;
   if (nElements > sliceSize)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, libplctag tag index: %d. Request to write more values than the configured sliceSize! nElements>sliceSize:  %ld > %ld.\n",
@@ -1790,51 +3179,66 @@ asynStatus drvOmronEIP::writeInt32Array(asynUser *pasynUser, epicsInt32 *value,
               driverName, functionName, tagIndex, nElements, sliceSize);
   }
 
-  if (datatype == "DINT")
+  switch (drvUser->cipType)
   {
-    for (size_t i = 0; i < sliceSize; i++)
-    {
-      /* If nElements is less than sliceSize, the remaining data is written as zeroes */
-      if (nElements <= i)
-        status = plc_tag_set_int32(tagIndex, offset + i * 4, 0);
-      else
-        status = plc_tag_set_int32(tagIndex, offset + i * 4, *(value + i));
-      if (status < 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-        return asynError;
-      }
-    }
+  case omronTypeDINT:
+    status = encodeNumeric<epicsInt32>(tagIndex, offset, value, nElements, sliceSize);
+    break;
+  case omronTypeUDINT:
+    status = encodeNumeric<epicsUInt32>(tagIndex, offset, value, nElements, sliceSize);
+    break;
+  default:
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
+    return asynError;
   }
-  else if (datatype == "UDINT")
+  if (status < 0)
   {
-    for (size_t i = 0; i < sliceSize; i++)
-    {
-      /* If nElements is less than sliceSize, the remaining data is written as zeroes */
-      if (nElements <= i)
-        status = plc_tag_set_uint32(tagIndex, offset + i * 4, 0);
-      else
-        status = plc_tag_set_uint32(tagIndex, offset + i * 4, *(value + i));
-      if (status < 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-        return asynError;
-      }
-    }
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
+    return asynError;
+  }
+
+  return sendWrite(pasynUser, drvUser, functionName);
+}
+
+asynStatus drvOmronEIP::writeInt64Array(asynUser *pasynUser, epicsInt64 *value, size_t nElements)
+{
+  const char *functionName = "writeInt64Array";
+  omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
+  int tagIndex = drvUser->tagIndex;
+  int offset = drvUser->tagOffset;
+  size_t sliceSize = drvUser->sliceSize;
+  int status = 0;
+  if (nElements > sliceSize)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, libplctag tag index: %d. Request to write more values than the configured sliceSize! nElements>sliceSize:  %ld > %ld.\n",
+              driverName, functionName, tagIndex, nElements, sliceSize);
+    return asynError;
+  }
+  else if (nElements < sliceSize)
+  {
+    asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, libplctag tag index: %d. Request to write less values than the configured sliceSize, missing data will be written as null. nElements<sliceSize:  %ld < %ld.\n",
+              driverName, functionName, tagIndex, nElements, sliceSize);
   }
-  else
+
+  switch (drvUser->cipType)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+  case omronTypeLINT:
+    status = encodeNumeric<epicsInt64>(tagIndex, offset, value, nElements, sliceSize);
+    break;
+  case omronTypeULINT:
+    status = encodeNumeric<epicsUInt64>(tagIndex, offset, value, nElements, sliceSize);
+    break;
+  default:
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
-
-  status = plc_tag_write(tagIndex, timeout);
   if (status < 0)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
     return asynError;
   }
-  return asynSuccess;
+
+  return sendWrite(pasynUser, drvUser, functionName);
 }
 
 asynStatus drvOmronEIP::writeFloat32Array(asynUser *pasynUser, epicsFloat32 *value, size_t nElements)
@@ -1843,10 +3247,8 @@ asynStatus drvOmronEIP::writeFloat32Array(asynUser *pasynUser, epicsFloat32 *val
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
   size_t sliceSize = drvUser->sliceSize;
   int status = 0;
-  double timeout = pasynUser->timeout * 1000;
   if (nElements > sliceSize)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, libplctag tag index: %d. Request to write more values than the configured sliceSize! nElements>sliceSize:  %ld > %ld.\n",
@@ -1859,35 +3261,22 @@ asynStatus drvOmronEIP::writeFloat32Array(asynUser *pasynUser, epicsFloat32 *val
               driverName, functionName, tagIndex, nElements, sliceSize);
   }
 
-  if (datatype == "REAL")
-  {
-    for (size_t i = 0; i < sliceSize; i++)
-    {
-      /* If nElements is less than sliceSize, the remaining data is written as zeroes */
-      if (nElements <= i)
-        status = plc_tag_set_float32(tagIndex, offset + i * 4, 0);
-      else
-        status = plc_tag_set_float32(tagIndex, offset + i * 4, *(value + i));
-      if (status < 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-        return asynError;
-      }
-    }
-  }
-  else
+  switch (drvUser->cipType)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+  case omronTypeREAL:
+    status = encodeNumeric<epicsFloat32>(tagIndex, offset, value, nElements, sliceSize);
+    break;
+  default:
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
-
-  status = plc_tag_write(tagIndex, timeout);
   if (status < 0)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
     return asynError;
   }
-  return asynSuccess;
+
+  return sendWrite(pasynUser, drvUser, functionName);
 }
 
 asynStatus drvOmronEIP::writeFloat64Array(asynUser *pasynUser, epicsFloat64 *value, size_t nElements)
@@ -1896,10 +3285,8 @@ asynStatus drvOmronEIP::writeFloat64Array(asynUser *pasynUser, epicsFloat64 *val
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
   size_t sliceSize = drvUser->sliceSize;
   int status = 0;
-  double timeout = pasynUser->timeout * 1000;
   if (nElements > sliceSize)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, libplctag tag index: %d. Request to write more values than the configured sliceSize! nElements>sliceSize:  %ld > %ld.\n",
@@ -1912,35 +3299,22 @@ asynStatus drvOmronEIP::writeFloat64Array(asynUser *pasynUser, epicsFloat64 *val
               driverName, functionName, tagIndex, nElements, sliceSize);
   }
 
-  if (datatype == "LREAL")
-  {
-    for (size_t i = 0; i < sliceSize; i++)
-    {
-      /* If nElements is less than sliceSize, the remaining data is written as zeroes */
-      if (nElements <= i)
-        status = plc_tag_set_float64(tagIndex, offset + i * 8, 0);
-      else
-        status = plc_tag_set_float64(tagIndex, offset + i * 8, *(value + i));
-      if (status < 0)
-      {
-        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-        return asynError;
-      }
-    }
-  }
-  else
+  switch (drvUser->cipType)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+  case omronTypeLREAL:
+    status = encodeNumeric<epicsFloat64>(tagIndex, offset, value, nElements, sliceSize);
+    break;
+  default:
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
-
-  status = plc_tag_write(tagIndex, timeout);
   if (status < 0)
   {
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
     return asynError;
   }
-  return asynSuccess;
+
+  return sendWrite(pasynUser, drvUser, functionName);
 }
 
 asynStatus drvOmronEIP::writeUInt32Digital(asynUser *pasynUser, epicsUInt32 value, epicsUInt32 mask)
@@ -1949,28 +3323,26 @@ asynStatus drvOmronEIP::writeUInt32Digital(asynUser *pasynUser, epicsUInt32 valu
   int status = 0;
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
-  int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
-  double timeout = pasynUser->timeout * 1000;
-  if (datatype == "BOOL")
+  if (drvUser->cipType == omronTypeBOOL)
   {
-    status = plc_tag_set_bit(tagIndex, offset, value);
-    if (status < 0)
-    {
-      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-      return asynError;
-    }
-    status = plc_tag_write(tagIndex, timeout);
-    if (status < 0)
+    // Only the bools selected by the records mask are changed, the others keep the value from the last read
+    size_t bools = std::min(drvUser->sliceSize, (size_t)32);
+    for (size_t i = 0; i < bools; i++)
     {
-      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-      return asynError;
+      if (!(mask & (1u << i)))
+        continue;
+      status = plc_tag_set_bit(tagIndex, boolBitOffset(drvUser, i), (value >> i) & 1);
+      if (status < 0)
+      {
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
+        return asynError;
+      }
     }
-    return asynSuccess;
+    return sendWrite(pasynUser, drvUser, functionName);
   }
   else
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
 }
@@ -1982,23 +3354,28 @@ asynStatus drvOmronEIP::writeInt32(asynUser *pasynUser, epicsInt32 value)
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
-  double timeout = pasynUser->timeout * 1000;
-  if (datatype == "SINT")
-    status = plc_tag_set_int8(tagIndex, offset, (epicsInt8)value);
-  else if (datatype == "INT")
-    status = plc_tag_set_int16(tagIndex, offset, (epicsInt16)value);
-  else if (datatype == "DINT")
-    status = plc_tag_set_int32(tagIndex, offset, value);
-  else if (datatype == "USINT")
-    status = plc_tag_set_uint8(tagIndex, offset, (epicsUInt8)value);
-  else if (datatype == "UINT")
-    status = plc_tag_set_uint16(tagIndex, offset, (epicsUInt16)value);
-  else if (datatype == "UDINT")
-    status = plc_tag_set_uint32(tagIndex, offset, (epicsUInt32)value);
-  else
+  switch (drvUser->cipType)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+  case omronTypeSINT:
+    status = encodeNumeric<epicsInt8>(tagIndex, offset, &value, 1, 1);
+    break;
+  case omronTypeINT:
+    status = encodeNumeric<epicsInt16>(tagIndex, offset, &value, 1, 1);
+    break;
+  case omronTypeDINT:
+    status = encodeNumeric<epicsInt32>(tagIndex, offset, &value, 1, 1);
+    break;
+  case omronTypeUSINT:
+    status = encodeNumeric<epicsUInt8>(tagIndex, offset, &value, 1, 1);
+    break;
+  case omronTypeUINT:
+    status = encodeNumeric<epicsUInt16>(tagIndex, offset, &value, 1, 1);
+    break;
+  case omronTypeUDINT:
+    status = encodeNumeric<epicsUInt32>(tagIndex, offset, &value, 1, 1);
+    break;
+  default:
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
 
@@ -2007,13 +3384,7 @@ asynStatus drvOmronEIP::writeInt32(asynUser *pasynUser, epicsInt32 value)
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
     return asynError;
   }
-  status = plc_tag_write(tagIndex, timeout);
-  if (status < 0)
-  {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-    return asynError;
-  }
-  return asynSuccess;
+  return sendWrite(pasynUser, drvUser, functionName);
 }
 
 asynStatus drvOmronEIP::writeInt64(asynUser *pasynUser, epicsInt64 value)
@@ -2023,15 +3394,17 @@ asynStatus drvOmronEIP::writeInt64(asynUser *pasynUser, epicsInt64 value)
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
-  double timeout = pasynUser->timeout * 1000;
-  if (datatype == "LINT" || datatype == "TIME")
-    status = plc_tag_set_int64(tagIndex, offset, value);
-  else if (datatype == "ULINT")
-    status = plc_tag_set_int64(tagIndex, offset, (epicsUInt64)value);
-  else
+  switch (drvUser->cipType)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+  case omronTypeLINT:
+  case omronTypeTIME:
+    status = encodeNumeric<epicsInt64>(tagIndex, offset, &value, 1, 1);
+    break;
+  case omronTypeULINT:
+    status = encodeNumeric<epicsUInt64>(tagIndex, offset, &value, 1, 1);
+    break;
+  default:
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
 
@@ -2040,13 +3413,7 @@ asynStatus drvOmronEIP::writeInt64(asynUser *pasynUser, epicsInt64 value)
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
     return asynError;
   }
-  status = plc_tag_write(tagIndex, timeout);
-  if (status < 0)
-  {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-    return asynError;
-  }
-  return asynSuccess;
+  return sendWrite(pasynUser, drvUser, functionName);
 }
 
 asynStatus drvOmronEIP::writeFloat64(asynUser *pasynUser, epicsFloat64 value)
@@ -2056,15 +3423,16 @@ asynStatus drvOmronEIP::writeFloat64(asynUser *pasynUser, epicsFloat64 value)
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
-  double timeout = pasynUser->timeout * 1000;
-  if (datatype == "REAL")
-    status = plc_tag_set_float32(tagIndex, offset, (epicsFloat32)value);
-  else if (datatype == "LREAL")
-    status = plc_tag_set_float64(tagIndex, offset, value);
-  else
+  switch (drvUser->cipType)
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+  case omronTypeREAL:
+    status = encodeNumeric<epicsFloat32>(tagIndex, offset, &value, 1, 1);
+    break;
+  case omronTypeLREAL:
+    status = encodeNumeric<epicsFloat64>(tagIndex, offset, &value, 1, 1);
+    break;
+  default:
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
 
@@ -2073,13 +3441,7 @@ asynStatus drvOmronEIP::writeFloat64(asynUser *pasynUser, epicsFloat64 value)
     asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
     return asynError;
   }
-  status = plc_tag_write(tagIndex, timeout);
-  if (status < 0)
-  {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-    return asynError;
-  }
-  return asynSuccess;
+  return sendWrite(pasynUser, drvUser, functionName);
 }
 
 asynStatus drvOmronEIP::writeOctet(asynUser *pasynUser, const char *value, size_t nChars, size_t *nActual)
@@ -2089,15 +3451,14 @@ asynStatus drvOmronEIP::writeOctet(asynUser *pasynUser, const char *value, size_
   omronDrvUser_t *drvUser = tagMap_.at(pasynUser->reason);
   int tagIndex = drvUser->tagIndex;
   int offset = drvUser->tagOffset;
-  std::string datatype = drvUser->dataType.first;
-  double timeout = pasynUser->timeout * 1000;
 
   /* This is a bit messy because Omron does strings a bit differently to what libplctag expects*/
-  if (datatype == "STRING")
+  if (drvUser->cipType == omronTypeSTRING)
   {
     int string_capacity = plc_tag_get_string_capacity(tagIndex, 0);
-    char stringOut[nChars + 1] = {'\0'}; // allow space for null character
-    snprintf(stringOut, sizeof(stringOut), value);
+    drvUser->writeBuffer.assign((const uint8_t *)value, (const uint8_t *)value + nChars);
+    drvUser->writeBuffer.push_back('\0'); // allow space for null character
+    const char *stringOut = (const char *)drvUser->writeBuffer.data();
 
     /* Set the tag buffer to the max size of string in PLC. Required as the tag size is set based
     on the current size of the tag in the PLC, but we may write a bigger string than this. */
@@ -2128,22 +3489,62 @@ asynStatus drvOmronEIP::writeOctet(asynUser *pasynUser, const char *value, size_
       asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Resizing libplctag tag buffer returned %s\n", driverName, functionName, plc_tag_decode_error(status));
       return asynError;
     }
-    status = plc_tag_write(tagIndex, timeout);
-    if (status < 0)
-    {
-      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Write attempt returned %s\n", driverName, functionName, plc_tag_decode_error(status));
-      return asynError;
-    }
+    status = sendWrite(pasynUser, drvUser, functionName);
+    if (status != asynSuccess)
+      return (asynStatus)status;
     memcpy(nActual, &nChars, sizeof(size_t));
   }
   else
   {
-    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, datatype.c_str());
+    asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid asyn interface for dtype: %s\n", driverName, functionName, drvUser->dataType.first.c_str());
     return asynError;
   }
   return asynSuccess;
 }
 
+void drvOmronEIP::report(FILE *fp, int details)
+{
+  const char *overrunNames[] = {"run_late", "skip", "catch_up"};
+  fprintf(fp, "%s: %zu asyn parameters, %zu libplctag tags, %zu pollers\n", driverName, asynParamCount, libplctagTagCount, pollerList_.size());
+  if (workerPool_ != NULL)
+    fprintf(fp, "  Scheduler mode with %d worker threads\n", workerPool_->threadCount_);
+  if (bandwidth_ != NULL)
+    fprintf(fp, "  Bandwidth limit: %.0f bytes/s %.1f requests/s, admitted %zu requests (%zu bytes), rejected %zu requests\n",
+            bandwidth_->bytesPerSec_, bandwidth_->requestsPerSec_, bandwidth_->admittedRequests_.load(), bandwidth_->admittedBytes_.load(), bandwidth_->rejectedRequests_.load());
+  if (decodePool_ != NULL)
+    fprintf(fp, "  Decoding with %d worker threads in chunks of %zu parameters\n", decodePool_->threadCount_, decodeChunkSize_);
+  if (asyncWrites_)
+    fprintf(fp, "  Asynchronous writes, sent: %zu failed: %zu\n", asyncWritesSent_.load(), asyncWritesFailed_.load());
+  if (coalesceWindow_ > 0)
+    fprintf(fp, "  Write coalescing window: %.3f s, writes merged into an earlier write: %zu\n", coalesceWindow_, coalescedWrites_.load());
+  for (auto poller : pollerList_)
+  {
+    omronEIPPoller *pPoller = poller.second;
+    fprintf(fp, "  Poller: %s interval: %f s phase offset: %f s reads: %zu tags updates: %zu parameters overrun policy: %s\n",
+            pPoller->pollerName_, pPoller->updateRate_, pPoller->phaseOffset_, pPoller->readList_.size(), pPoller->decodeList_.size(), overrunNames[pPoller->overrunPolicy_]);
+    fprintf(fp, "    cycles: %zu overruns: %zu skipped cycles: %zu last cycle: %.3f ms max cycle: %.3f ms\n",
+            pPoller->cycleCount_, pPoller->overrunCount_, pPoller->skippedCycles_, pPoller->lastCycleTime_ * 1E3, pPoller->maxCycleTime_ * 1E3);
+    if (bandwidth_ != NULL)
+      fprintf(fp, "    priority: %d reads skipped by the bandwidth limit: %zu\n", pPoller->priority_, pPoller->budgetSkips_);
+    if (pPoller->onDemand_)
+    {
+      size_t demandedTags = 0;
+      for (const omronPollEntry_t &entry : pPoller->readList_)
+        demandedTags += tagDemanded(pPoller, entry.drvUser);
+      fprintf(fp, "    on demand, reading %zu of %zu tags\n", demandedTags, pPoller->readList_.size());
+    }
+    if (pPoller->maxInFlight_ > 0 && pPoller->windowRequests_ > 0)
+      fprintf(fp, "    window: %d requests, mean occupancy: %.2f (%.0f%%), window full: %zu of %zu requests, deferred: %zu\n",
+              pPoller->maxInFlight_, (double)pPoller->windowOccupancySum_ / pPoller->windowRequests_,
+              100.0 * pPoller->windowOccupancySum_ / pPoller->windowRequests_ / pPoller->maxInFlight_,
+              pPoller->windowFullCount_, pPoller->windowRequests_, pPoller->windowSkips_);
+    if (pPoller->spreadRequests_ == 2)
+      fprintf(fp, "    adaptive pacing, in flight: %d target in flight: %.1f round trip time: %.3f ms deferred: %zu\n",
+              (int)pPoller->inFlight_, pPoller->targetInFlight_, pPoller->rttEstimate_ * 1E3, pPoller->windowSkips_);
+  }
+  asynPortDriver::report(fp, details);
+}
+
 omronDrvUser_t* drvOmronEIP::getDrvUser(int asynIndex)
 {
   return (this->tagMap_.at(asynIndex));
@@ -2151,17 +3552,45 @@ omronDrvUser_t* drvOmronEIP::getDrvUser(int asynIndex)
 
 drvOmronEIP::~drvOmronEIP()
 {
-  std::cout << "drvOmronEIP shutting down" << std::endl;
+  static const char *functionName = "~drvOmronEIP";
+  asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Driver: %s shutting down\n", driverName, functionName, portName);
   if (!omronExiting){
     //This should be set true by the epicsExit callback, but if this destructor is called independently, then we can do it here
     //It tells the pollers to quit the polling loop and destruct.
     omronExiting = true;  
-    epicsThreadSleep(2);
   }
   int status = 0;
+  if (schedulerExited_ != NULL)
+  {
+    // The scheduler hands work to the pool and reads the pollers, so it must stop before either is deleted
+    epicsEventSignal(schedulerWake_);
+    epicsEventWait(schedulerExited_);
+  }
+  if (writeFlusherExited_ != NULL)
+  {
+    // writeFlusher() uses the port lock and the tag states, and sends writes which would call tagCallback()
+    epicsEventSignal(flushWake_);
+    epicsEventWait(writeFlusherExited_);
+  }
+  // The poller threads wait on their pollers events and submit decode jobs to decodePool_, so they must stop before either is deleted
+  for (auto mi : pollerList_)
+  {
+    if (mi.second->threadExited_ != NULL)
+      epicsEventWait(mi.second->threadExited_);
+  }
+  // Stop libplctag from calling tagCallback(), which submits jobs to writeCompletions_ and signals the pollers
+  for (auto &tagState : tagStates_)
+  {
+    plc_tag_unregister_callback(tagState.first);
+  }
   delete utilities;
+  delete workerPool_;
+  delete decodePool_;
+  delete writeCompletions_;
+  delete bandwidth_;
   for (auto mi : pollerList_)
   {
+    asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "%s:%s Poller: %s shutting down\n", driverName, functionName, mi.second->pollerName_);
     delete mi.second;
   }
 
@@ -2180,7 +3609,235 @@ drvOmronEIP::~drvOmronEIP()
 
 omronEIPPoller::~omronEIPPoller()
 {
-  std::cout << "Poller " << this->pollerName_ << " shutting down" << std::endl;
+  epicsEventDestroy(readComplete_);
+  epicsEventDestroy(decodeDone_);
+  if (threadExited_ != NULL)
+    epicsEventDestroy(threadExited_);
+  epicsMutexDestroy(pacingLock_);
+}
+
+omronWorkerPool::omronWorkerPool(const char *poolName, int threadCount) : threadCount_(threadCount),
+                                                                         exiting_(false),
+                                                                         runningThreads_(0)
+{
+  jobsLock_ = epicsMutexMustCreate();
+  jobsAvailable_ = epicsEventMustCreate(epicsEventEmpty);
+  threadsExited_ = epicsEventMustCreate(epicsEventEmpty);
+  for (int i = 0; i < threadCount_; i++)
+  {
+    std::string threadName = (std::string)poolName + std::to_string(i);
+    epicsMutexMustLock(jobsLock_);
+    runningThreads_++;
+    epicsMutexUnlock(jobsLock_);
+    if (epicsThreadCreate(threadName.c_str(),
+                          epicsThreadPriorityMedium,
+                          epicsThreadGetStackSize(epicsThreadStackMedium),
+                          (EPICSTHREADFUNC)workerC,
+                          this) == NULL)
+    {
+      epicsMutexMustLock(jobsLock_);
+      runningThreads_--;
+      epicsMutexUnlock(jobsLock_);
+      std::cout << "Error, failed to create worker thread " << threadName << std::endl;
+    }
+  }
+}
+
+void omronWorkerPool::submit(std::function<void()> job)
+{
+  epicsMutexMustLock(jobsLock_);
+  jobs_.push_back(job);
+  epicsMutexUnlock(jobsLock_);
+  epicsEventSignal(jobsAvailable_);
+}
+
+void omronWorkerPool::workerLoop()
+{
+  std::function<void()> job;
+  bool moreJobs;
+  bool exiting = false;
+  while (!exiting)
+  {
+    epicsEventWait(jobsAvailable_);
+    while (true)
+    {
+      epicsMutexMustLock(jobsLock_);
+      // Jobs which were queued before the pool was deleted still run, their submitters may be waiting for them
+      exiting = exiting_ && jobs_.empty();
+      if (jobs_.empty())
+      {
+        epicsMutexUnlock(jobsLock_);
+        break;
+      }
+      job = jobs_.front();
+      jobs_.pop_front();
+      moreJobs = !jobs_.empty();
+      epicsMutexUnlock(jobsLock_);
+      // The event only wakes one worker, so pass the wake up on if there is still work to do
+      if (moreJobs)
+        epicsEventSignal(jobsAvailable_);
+      job();
+    }
+  }
+  // Make sure the next worker also sees that we are exiting
+  epicsEventSignal(jobsAvailable_);
+  // The destructor takes jobsLock_ before it destroys anything, so the pool is still there until we release it
+  epicsMutexMustLock(jobsLock_);
+  runningThreads_--;
+  epicsEventSignal(threadsExited_);
+  epicsMutexUnlock(jobsLock_);
+}
+
+omronWorkerPool::~omronWorkerPool()
+{
+  epicsMutexMustLock(jobsLock_);
+  exiting_ = true;
+  epicsMutexUnlock(jobsLock_);
+  epicsEventSignal(jobsAvailable_);
+  // The workers finish the queued jobs first, which use objects that the owner deletes after the pool, so we wait for every worker
+  epicsMutexMustLock(jobsLock_);
+  while (runningThreads_ > 0)
+  {
+    epicsMutexUnlock(jobsLock_);
+    epicsEventWaitWithTimeout(threadsExited_, 1.0);
+    epicsMutexMustLock(jobsLock_);
+  }
+  epicsMutexUnlock(jobsLock_);
+  epicsEventDestroy(threadsExited_);
+  epicsEventDestroy(jobsAvailable_);
+  epicsMutexDestroy(jobsLock_);
+}
+
+void omronTimeFormatter::rebuild(time_t secs)
+{
+  struct tm local, other;
+  epicsTime_localtime(&secs, &local);
+  datePrefixLength_ = strftime(datePrefix_, sizeof(datePrefix_), "%Y-%m-%d ", &local);
+  time_t secondsIntoHour = local.tm_min * 60 + local.tm_sec;
+  dayStart_ = secs - local.tm_hour * 3600 - secondsIntoHour;
+  validFrom_ = dayStart_;
+  validTo_ = dayStart_ + 86400;
+  // On the days that daylight saving starts or ends the offset to the start of the day changes part way through the day. Changes
+  // happen on the hour, so on these days we only cache the current hour
+  time_t dayEnd = validTo_ - 1;
+  epicsTime_localtime(&dayStart_, &other);
+  bool changesToday = (other.tm_isdst != local.tm_isdst);
+  epicsTime_localtime(&dayEnd, &other);
+  changesToday = changesToday || (other.tm_isdst != local.tm_isdst);
+  if (changesToday)
+  {
+    validFrom_ = secs - secondsIntoHour;
+    validTo_ = validFrom_ + 3600;
+    dayStart_ = validFrom_ - local.tm_hour * 3600;
+  }
+}
+
+size_t omronTimeFormatter::format(int64_t nsSinceEpoch, int decimals, char *buff)
+{
+  // Round down towards minus infinity, so that times before 1970 keep a positive fraction of a second
+  int64_t secs = nsSinceEpoch / 1000000000;
+  int64_t nsec = nsSinceEpoch % 1000000000;
+  if (nsec < 0)
+  {
+    secs--;
+    nsec += 1000000000;
+  }
+  if (secs < validFrom_ || secs >= validTo_)
+    rebuild((time_t)secs);
+  int secondsIntoDay = (int)(secs - dayStart_);
+  int hour = secondsIntoDay / 3600;
+  int minute = secondsIntoDay / 60 % 60;
+  int second = secondsIntoDay % 60;
+  memcpy(buff, datePrefix_, datePrefixLength_);
+  char *p = buff + datePrefixLength_;
+  *p++ = '0' + hour / 10;
+  *p++ = '0' + hour % 10;
+  *p++ = ':';
+  *p++ = '0' + minute / 10;
+  *p++ = '0' + minute % 10;
+  *p++ = ':';
+  *p++ = '0' + second / 10;
+  *p++ = '0' + second % 10;
+  if (decimals > 0)
+  {
+    *p++ = '.';
+    int divisor = 100000000;
+    for (int i = 0; i < decimals && i < 9; i++, divisor /= 10)
+      *p++ = '0' + (nsec / divisor) % 10;
+  }
+  *p = 0;
+  return p - buff;
+}
+
+omronTokenBucket::omronTokenBucket(double bytesPerSec, double requestsPerSec) : bytesPerSec_(bytesPerSec),
+                                                                                requestsPerSec_(requestsPerSec),
+                                                                                admittedRequests_(0),
+                                                                                admittedBytes_(0),
+                                                                                rejectedRequests_(0),
+                                                                                byteTokens_(0),
+                                                                                requestTokens_(0)
+{
+  bucketLock_ = epicsMutexMustCreate();
+  lastRefill_ = std::chrono::steady_clock::now();
+}
+
+omronTokenBucket::~omronTokenBucket()
+{
+  epicsMutexDestroy(bucketLock_);
+}
+
+void omronTokenBucket::refill()
+{
+  const double burstTime = 0.1; // the bucket holds at most this many seconds worth of tokens, which bounds the size of a burst
+  auto now = std::chrono::steady_clock::now();
+  double elapsed = std::chrono::duration<double>(now - lastRefill_).count();
+  lastRefill_ = now;
+  byteTokens_ = std::min(std::max(bytesPerSec_ * burstTime, 1.0), byteTokens_ + elapsed * bytesPerSec_);
+  requestTokens_ = std::min(std::max(requestsPerSec_ * burstTime, 1.0), requestTokens_ + elapsed * requestsPerSec_);
+}
+
+bool omronTokenBucket::acquire(int priority, double updateRate, double bytes, double timeout)
+{
+  std::pair<int, double> key(priority, -updateRate);
+  auto start = std::chrono::steady_clock::now();
+  double waitTime;
+  epicsMutexMustLock(bucketLock_);
+  auto waiter = waiting_.insert(key);
+  while (true)
+  {
+    refill();
+    bool bytesReady = (bytesPerSec_ == 0 || byteTokens_ > 0);
+    bool requestsReady = (requestsPerSec_ == 0 || requestTokens_ > 0);
+    // Only the waiter with the highest priority may take tokens, so lower priority pollers cannot starve higher priority ones
+    if (bytesReady && requestsReady && !(*waiting_.rbegin() > key))
+    {
+      byteTokens_ -= bytes;
+      requestTokens_ -= 1;
+      admittedRequests_++;
+      admittedBytes_ += (size_t)bytes;
+      waiting_.erase(waiter);
+      epicsMutexUnlock(bucketLock_);
+      return true;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (elapsed >= timeout || omronExiting)
+    {
+      rejectedRequests_++;
+      waiting_.erase(waiter);
+      epicsMutexUnlock(bucketLock_);
+      return false;
+    }
+    // Sleep until enough tokens should have arrived, the tokens may be taken by a higher priority poller in the meantime
+    waitTime = 0;
+    if (!bytesReady)
+      waitTime = std::max(waitTime, -byteTokens_ / bytesPerSec_);
+    if (!requestsReady)
+      waitTime = std::max(waitTime, -requestTokens_ / requestsPerSec_);
+    waitTime = std::min(std::max(waitTime, epicsThreadSleepQuantum()), timeout - elapsed);
+    epicsMutexUnlock(bucketLock_);
+    epicsThreadSleep(waitTime);
+    epicsMutexMustLock(bucketLock_);
+  }
 }
 
 extern "C"
@@ -2224,17 +3881,169 @@ extern "C"
     drvOmronEIPStructDefine(args[0].sval, args[1].sval);
   }
 
+  /** drvOmronEIPConfigScheduler() - Runs all of the drivers pollers from one scheduler thread and a pool of worker threads, rather
+  * than giving each poller its own thread. Must be called before any pollers are created.
+  * \param[in] portName The name of the asynPort connected to the omron driver.
+  * \param[in] workerThreads The number of threads which wait for and decode the replies to each pollers read requests.
+  */
+  asynStatus drvOmronEIPConfigScheduler(const char *portName, int workerThreads)
+  {
+    drvOmronEIP *pDriver = (drvOmronEIP *)findAsynPortDriver(portName);
+    if (!pDriver)
+    {
+      std::cout << "Error, Port " << portName << " not found!" << std::endl;
+      return asynError;
+    }
+    else
+    {
+      return pDriver->createScheduler(workerThreads);
+    }
+  }
+
+  /* iocsh functions */
+
+  static const iocshArg schedulerConfigArg0 = {"Port name", iocshArgString};
+  static const iocshArg schedulerConfigArg1 = {"Worker threads", iocshArgInt};
+
+  static const iocshArg *const drvOmronEIPConfigSchedulerArgs[2] = {
+      &schedulerConfigArg0,
+      &schedulerConfigArg1};
+
+  static const iocshFuncDef drvOmronEIPConfigSchedulerFuncDef = {"drvOmronEIPConfigScheduler", 2, drvOmronEIPConfigSchedulerArgs};
+
+  static void drvOmronEIPConfigSchedulerCallFunc(const iocshArgBuf *args)
+  {
+    drvOmronEIPConfigScheduler(args[0].sval, args[1].ival);
+  }
+
+  /** drvOmronEIPConfigBandwidth() - Limits the rate at which all of the drivers pollers together send read requests to the PLC.
+  * \param[in] portName The name of the asynPort connected to the omron driver.
+  * \param[in] bytesPerSec The most reply data in bytes per second which may be requested, 0 for no limit.
+  * \param[in] requestsPerSec The most read requests per second, 0 for no limit.
+  */
+  asynStatus drvOmronEIPConfigBandwidth(const char *portName, double bytesPerSec, double requestsPerSec)
+  {
+    drvOmronEIP *pDriver = (drvOmronEIP *)findAsynPortDriver(portName);
+    if (!pDriver)
+    {
+      std::cout << "Error, Port " << portName << " not found!" << std::endl;
+      return asynError;
+    }
+    else
+    {
+      return pDriver->createBandwidthLimit(bytesPerSec, requestsPerSec);
+    }
+  }
+
+  /* iocsh functions */
+
+  static const iocshArg bandwidthConfigArg0 = {"Port name", iocshArgString};
+  static const iocshArg bandwidthConfigArg1 = {"Bytes per second", iocshArgDouble};
+  static const iocshArg bandwidthConfigArg2 = {"Requests per second", iocshArgDouble};
+
+  static const iocshArg *const drvOmronEIPConfigBandwidthArgs[3] = {
+      &bandwidthConfigArg0,
+      &bandwidthConfigArg1,
+      &bandwidthConfigArg2};
+
+  static const iocshFuncDef drvOmronEIPConfigBandwidthFuncDef = {"drvOmronEIPConfigBandwidth", 3, drvOmronEIPConfigBandwidthArgs};
+
+  static void drvOmronEIPConfigBandwidthCallFunc(const iocshArgBuf *args)
+  {
+    drvOmronEIPConfigBandwidth(args[0].sval, args[1].dval, args[2].dval);
+  }
+
+  /** drvOmronEIPConfigWrites() - Chooses whether the drivers write overrides keep the port locked while they wait for the PLC to reply.
+  * \param[in] portName The name of the asynPort connected to the omron driver.
+  * \param[in] asyncWrites If 1, the records still wait for the reply but the port is unlocked while they wait, so that pollers 
+  *            and writes queued behind a write in flight are not held up.
+  * \param[in] coalesceWindow Writes to the same tag within this many seconds of the first are sent as one write, 0 to disable.
+  *            Coalesced writes complete their records when they are queued, a failed write sets the alarm of its asyn parameter
+  *            which output records only see if they have asyn:READBACK set.
+  */
+  asynStatus drvOmronEIPConfigWrites(const char *portName, int asyncWrites, double coalesceWindow)
+  {
+    drvOmronEIP *pDriver = (drvOmronEIP *)findAsynPortDriver(portName);
+    if (!pDriver)
+    {
+      std::cout << "Error, Port " << portName << " not found!" << std::endl;
+      return asynError;
+    }
+    else
+    {
+      return pDriver->configureWrites(asyncWrites, coalesceWindow);
+    }
+  }
+
+  /* iocsh functions */
+
+  static const iocshArg writesConfigArg0 = {"Port name", iocshArgString};
+  static const iocshArg writesConfigArg1 = {"Asynchronous writes", iocshArgInt};
+  static const iocshArg writesConfigArg2 = {"Coalescing window", iocshArgDouble};
+
+  static const iocshArg *const drvOmronEIPConfigWritesArgs[3] = {
+      &writesConfigArg0,
+      &writesConfigArg1,
+      &writesConfigArg2};
+
+  static const iocshFuncDef drvOmronEIPConfigWritesFuncDef = {"drvOmronEIPConfigWrites", 3, drvOmronEIPConfigWritesArgs};
+
+  static void drvOmronEIPConfigWritesCallFunc(const iocshArgBuf *args)
+  {
+    drvOmronEIPConfigWrites(args[0].sval, args[1].ival, args[2].dval);
+  }
+
+  /** drvOmronEIPConfigDecodeWorkers() - Decodes the results of each poll cycle on a pool of worker threads rather than on the poller thread.
+  * \param[in] portName The name of the asynPort connected to the omron driver.
+  * \param[in] workerThreads The number of decode threads, usually no more than the number of CPU cores.
+  * \param[in] chunkSize The number of asyn parameters decoded by each job. Pollers with no more parameters than this are decoded on the poller thread.
+  */
+  asynStatus drvOmronEIPConfigDecodeWorkers(const char *portName, int workerThreads, int chunkSize)
+  {
+    drvOmronEIP *pDriver = (drvOmronEIP *)findAsynPortDriver(portName);
+    if (!pDriver)
+    {
+      std::cout << "Error, Port " << portName << " not found!" << std::endl;
+      return asynError;
+    }
+    else
+    {
+      return pDriver->createDecodeWorkers(workerThreads, chunkSize);
+    }
+  }
+
+  /* iocsh functions */
+
+  static const iocshArg decodeWorkersConfigArg0 = {"Port name", iocshArgString};
+  static const iocshArg decodeWorkersConfigArg1 = {"Worker threads", iocshArgInt};
+  static const iocshArg decodeWorkersConfigArg2 = {"Chunk size", iocshArgInt};
+
+  static const iocshArg *const drvOmronEIPConfigDecodeWorkersArgs[3] = {
+      &decodeWorkersConfigArg0,
+      &decodeWorkersConfigArg1,
+      &decodeWorkersConfigArg2};
+
+  static const iocshFuncDef drvOmronEIPConfigDecodeWorkersFuncDef = {"drvOmronEIPConfigDecodeWorkers", 3, drvOmronEIPConfigDecodeWorkersArgs};
+
+  static void drvOmronEIPConfigDecodeWorkersCallFunc(const iocshArgBuf *args)
+  {
+    drvOmronEIPConfigDecodeWorkers(args[0].sval, args[1].ival, args[2].ival);
+  }
+
   /** drvOmronEIPConfigPoller() - Creates a new poller with user provided settings and adds it to the driver.
   * \param[in] portName The name of the asynPort connected to the omron driver which will create this poller.
   * \param[in] pollerName The name of this poller, this needs to be referenced by records that need to use this poller.
   * \param[in] updateRate The time in seconds between polls.
   * \param[in] spreadRequests Rather than sending requests as fast as possible (default=0), we spread requests over the polling interval 
-   to create a smoother load on the plc and network.
+   to create a smoother load on the plc and network. If set to 2, requests are paced adaptively, keeping a target number of requests
+   in flight which is adjusted according to the PLCs measured response time.
+  * \param[in] pollerOptions Optional string of &option=value pairs which change the behaviour of the poller, eg "&overrun=skip".
   */
   asynStatus drvOmronEIPConfigPoller(const char *portName,
                                      const char *pollerName,
                                      double updateRate,
-                                     int spreadRequests)
+                                     int spreadRequests,
+                                     const char *pollerOptions)
   {
     drvOmronEIP *pDriver = (drvOmronEIP *)findAsynPortDriver(portName);
     if (!pDriver)
@@ -2244,7 +4053,7 @@ extern "C"
     }
     else
     {
-      return pDriver->createPoller(portName, pollerName, updateRate, spreadRequests);
+      return pDriver->createPoller(portName, pollerName, updateRate, spreadRequests, pollerOptions);
     }
   }
 
@@ -2254,18 +4063,20 @@ extern "C"
   static const iocshArg pollerConfigArg1 = {"Poller name", iocshArgString};
   static const iocshArg pollerConfigArg2 = {"Update rate", iocshArgDouble};
   static const iocshArg pollerConfigArg3 = {"Spread requests", iocshArgInt};
+  static const iocshArg pollerConfigArg4 = {"Poller options", iocshArgString};
 
-  static const iocshArg *const drvOmronEIPConfigPollerArgs[4] = {
+  static const iocshArg *const drvOmronEIPConfigPollerArgs[5] = {
       &pollerConfigArg0,
       &pollerConfigArg1,
       &pollerConfigArg2,
-      &pollerConfigArg3};
+      &pollerConfigArg3,
+      &pollerConfigArg4};
 
-  static const iocshFuncDef drvOmronEIPConfigPollerFuncDef = {"drvOmronEIPConfigPoller", 4, drvOmronEIPConfigPollerArgs};
+  static const iocshFuncDef drvOmronEIPConfigPollerFuncDef = {"drvOmronEIPConfigPoller", 5, drvOmronEIPConfigPollerArgs};
 
   static void drvOmronEIPConfigPollerCallFunc(const iocshArgBuf *args)
   {
-    drvOmronEIPConfigPoller(args[0].sval, args[1].sval, args[2].dval, args[3].ival);
+    drvOmronEIPConfigPoller(args[0].sval, args[1].sval, args[2].dval, args[3].ival, args[4].sval);
   }
 
   /** EPICS iocsh callable function to call constructor for the drvOmroneip class. 
@@ -2321,6 +4132,10 @@ extern "C"
   {
     iocshRegister(&drvOmronEIPConfigureFuncDef, drvOmronEIPConfigureCallFunc);
     iocshRegister(&drvOmronEIPConfigPollerFuncDef, drvOmronEIPConfigPollerCallFunc);
+    iocshRegister(&drvOmronEIPConfigSchedulerFuncDef, drvOmronEIPConfigSchedulerCallFunc);
+    iocshRegister(&drvOmronEIPConfigDecodeWorkersFuncDef, drvOmronEIPConfigDecodeWorkersCallFunc);
+    iocshRegister(&drvOmronEIPConfigBandwidthFuncDef, drvOmronEIPConfigBandwidthCallFunc);
+    iocshRegister(&drvOmronEIPConfigWritesFuncDef, drvOmronEIPConfigWritesCallFunc);
     iocshRegister(&drvOmronEIPStructDefineFuncDef, drvOmronEIPStructDefineCallFunc);
   }
 
@@ -21,6 +21,12 @@
 #include <iterator>
 #include <sstream>
 #include <bitset>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <set>
+#include <type_traits>
 
 /* EPICS includes */
 #include <dbAccess.h>
@@ -52,9 +58,54 @@
 #define CREATE_TAG_TIMEOUT 1000 //ms
 
 typedef std::pair<std::string, uint16_t> omronDataType_t;
+/** The CIP datatypes supported by the driver, in the same order as drvOmronEIP::omronDataTypeList. Resolved once from the dataType
+ *  string when the asyn parameter is created so that reads and writes do not need to compare strings */
+enum omronCipType_t
+{
+  omronTypeBOOL,
+  omronTypeSINT,
+  omronTypeUSINT,
+  omronTypeINT,
+  omronTypeUINT,
+  omronTypeDINT,
+  omronTypeUDINT,
+  omronTypeLINT,
+  omronTypeULINT,
+  omronTypeREAL,
+  omronTypeLREAL,
+  omronTypeSTRING,
+  omronTypeWORD,
+  omronTypeDWORD,
+  omronTypeLWORD,
+  omronTypeUDT,
+  omronTypeTIME
+};
 typedef std::unordered_map<std::string, std::vector<int>> optimiseMap;
 typedef std::unordered_map<std::string, std::vector<std::string>> structDtypeMap;
 typedef std::unordered_map<std::string, std::string> drvInfoMap;
+/** Asyn parameter updates made by a decode worker, which are applied later under the port lock */
+typedef std::vector<std::function<asynStatus()>> omronUpdateList;
+
+/** Formats TIME values as "YYYY-MM-DD HH:MM:SS" strings in the local timezone. The date and the start of the local day are cached,
+ *  so the timezone is only looked up again when a value falls outside of the cached day. Each parameter has its own formatter, which
+ *  is only used by the poller which decodes the parameter, so it is not locked */
+class omronTimeFormatter{
+  public:
+      /** Writes nsSinceEpoch (nanoseconds since 1970 UTC) into buff as local time with decimals digits after the seconds, 0 to 9.
+       *  buff must hold at least 30 characters. Returns the length of the string */
+      size_t format(int64_t nsSinceEpoch, int decimals, char *buff);
+  private:
+      /** Looks up the local date and the start of the local day of secs, and the range of times for which these can be reused */
+      void rebuild(time_t secs);
+      /** The cache is valid for times from validFrom_ up to but not including validTo_, it starts empty */
+      time_t validFrom_ = 1;
+      time_t validTo_ = 0;
+      /** The time at which the cached local day started, times within the day are formatted from their offset to this */
+      time_t dayStart_ = 0;
+      /** "YYYY-MM-DD " of the cached day */
+      char datePrefix_[16] = {0};
+      size_t datePrefixLength_ = 0;
+};
 
 /** This stores information about each communication tag to the PLC.
  *  A new instance will be made for each record which requsts to uniquely read/write to the PLC
@@ -77,6 +128,8 @@ struct omronDrvUser_t
   size_t sliceSize;
   /**CIP datatype string and byte size*/
   omronDataType_t dataType;
+  /**The datatype resolved from dataType.first, used to pick the decoder and encoder*/
+  omronCipType_t cipType;
   /**Contains a string describing the optimisation state of an asyn parameter*/
   std::string optimisationFlag;
   /**Size of the string within the PLC*/
@@ -87,13 +140,115 @@ struct omronDrvUser_t
   size_t offsetReadSize;
   /**Whether to output data as a string (only valid for TIME dtypes atm)*/
   bool readAsString;
+  /**The number of digits after the seconds when a TIME is output as a string*/
+  int timeDecimals;
+  /**Used by readData() to output a TIME as a string*/
+  omronTimeFormatter timeFormatter;
   /**if 0 then we use the offset to look within a datatype, if 1 then we use it to get a datatype from within an array/UDT*/
   bool optimise;
+  /**Only update the asyn parameter when the raw bytes it is decoded from have changed*/
+  bool publishOnChange;
+  /**Copy of the bytes of the tag which this parameter is decoded from, taken by readData() while the tag is locked so that the
+   * tag can be unlocked before decoding. Starts at the byte given by takeSnapshot()*/
+  std::vector<uint8_t> snapshot;
+  /**Scratch space used by readData() while decoding this parameter, kept between reads so that polling does not allocate.
+   * Only one poller decodes a given parameter so this is never used by two threads at once*/
+  std::vector<uint8_t> readBuffer;
+  /**Scratch space used by the write overrides, which asyn never calls concurrently for the same port*/
+  std::vector<uint8_t> writeBuffer;
+  /**Copy of the raw bytes which were last published, only used if publishOnChange is set*/
+  std::vector<uint8_t> shadowBytes;
+  /**True if shadowBytes holds the bytes of the last successful update*/
+  bool shadowValid;
+  /**Changes smaller than this are not published, 0 disables the deadband*/
+  double deadband;
+  /**If true, deadband is a percentage of lastPublished rather than an absolute value*/
+  bool deadbandPercent;
+  /**The last value which was published, only used if deadband is set*/
+  double lastPublished;
+  /**True if lastPublished holds the value of the last successful update*/
+  bool lastPublishedValid;
+  /**The tag is only read on every pollEvery cycles of its poller*/
+  int pollEvery;
+  /**The cycle within pollEvery on which the tag is read, chosen by buildPollerLists() to spread the reads evenly*/
+  int pollPhase;
+  /**If true, this TIME value is used as the timestamp of every parameter decoded from the same tag*/
+  bool plcTimestamp;
+};
+
+/** An entry in one of a pollers read or decode lists, these are built once by buildPollerLists() so that the pollers do not
+ *  need to search the tagMap_ on every cycle */
+struct omronPollEntry_t
+{
+  /**drvUser of the asyn parameter*/
+  omronDrvUser_t *drvUser;
+  /**Index of the asyn parameter*/
+  int asynIndex;
+};
+
+class omronEIPPoller;
+
+/** Tracks the polling of one libplctag tag, used by tagCallback() */
+struct omronTagState_t
+{
+  /**Pollers which decode this tag and must be woken when a read of it completes*/
+  std::vector<omronEIPPoller*> pollers;
+  /**The poller which sends read requests for this tag, NULL if no poller reads it*/
+  omronEIPPoller *reader = NULL;
+  /**Time at which the last paced or windowed read request was sent*/
+  std::chrono::steady_clock::time_point issueTime;
+  /**True while a paced or windowed read request is waiting for its reply*/
+  std::atomic<bool> inFlight{false};
+  /**Copied from the drvUser of the reader, the tag is read when the readers cycle % pollEvery == pollPhase*/
+  int pollEvery = 1;
+  int pollPhase = 0;
+  /**True if admitRead() skipped the last read of this tag, so the tag is not decoded*/
+  std::atomic<bool> budgetSkipped{false};
+  /**False if no record which uses this tag has subscribed to updates, only used by on_demand pollers*/
+  std::atomic<bool> demanded{true};
+  /**Time at which the last successful reply for this tag arrived, set by tagCallback(). Packed as secPastEpoch << 32 | nsec 
+   * so that it can be updated atomically, 0 if no reply has arrived yet*/
+  std::atomic<uint64_t> replyTime{0};
+  /**A TIME parameter with plc_timestamp set whose value is used as the timestamp of this tag instead of replyTime, NULL if none*/
+  omronDrvUser_t *timestampSource = NULL;
+  /**True while an asynchronous write of this tag is waiting for its reply*/
+  std::atomic<bool> writeInFlight{false};
+  /**The asyn parameters whose values are sent by the asynchronous write in flight, protected by writeLock_*/
+  std::vector<int> writeParams;
+  /**Time at which the asynchronous write in flight was sent*/
+  std::chrono::steady_clock::time_point writeSentTime;
+  /**True while writes to this tag are waiting to be sent together, in the coalescing window or behind a write in flight. Changed
+   * under writeLock_*/
+  std::atomic<bool> writeQueued{false};
+  /**The asyn parameters written during the coalescing window, protected by writeLock_*/
+  std::vector<int> queuedParams;
+  /**Time at which the queued writes are sent, and the longest timeout of the records which queued them. Protected by writeLock_*/
+  std::chrono::steady_clock::time_point flushTime;
+  double queuedTimeout = 0;
+  /**True if the last read of this tag was skipped because writes were queued, so the tag is not decoded*/
+  std::atomic<bool> writeSkipped{false};
+  /**Number of asynchronous writes of this tag which have been sent and which have finished, and the libplctag status of the last
+   * one to finish. sendWrite() waits until they are equal. Protected by writeLock_*/
+  size_t writesSent = 0;
+  size_t writesDone = 0;
+  int lastWriteStatus = 0;
 };
 
+/** What a poller does when a cycle finishes after the deadline of the next cycle */
+enum omronOverrunPolicy_t
+{
+  /**Start the next cycle straight away and measure later deadlines from this late start*/
+  overrunRunLate,
+  /**Drop the missed cycles and wait for the next deadline on the original phase*/
+  overrunSkip,
+  /**Run the missed cycles back to back until the poller is back on its original phase*/
+  overrunCatchUp
+};
 
 class omronEIPPoller;
 class omronUtilities;
+class omronWorkerPool;
+class omronTokenBucket;
 
 /** Main class for the driver */
 class epicsShareClass drvOmronEIP : public asynPortDriver {
@@ -138,11 +293,134 @@ public:
    /** All reading of data is initiated from this function which runs at a predefined frequency. Each poller runs this function
     * in its own thread. This function sends read requests to the PLC and then calls readData() which gets the data from libplctag */
    void readPoller();
+   /** Used instead of readPoller() when drvOmronEIPConfigScheduler has been called. A single thread keeps a min-heap of poller deadlines,
+    * sends the read requests of every poller which is due and waits for their replies. Once all of a pollers replies have arrived or 
+    * timed out, the poller is passed to the worker pool to be decoded */
+   void schedulerLoop();
+   /** Used by schedulerLoop(). Returns true if every read which pPoller decodes this cycle has finished or timed out. Otherwise returns
+    * false and lowers waitTime to the time left until the first pending read times out. Carries on from the last parameter which it 
+    * found pending, so each parameter is only checked once per cycle */
+   bool repliesArrived(omronEIPPoller *pPoller, double &waitTime);
+   /** Only runs when asynchronous writes are enabled. Sends the writes which have been queued for each tag once its coalescing window
+    * closes and the last write of the tag has finished */
+   void writeFlusher();
+   /** Sends the read requests for one cycle of a poller */
+   void issueReads(omronEIPPoller *pPoller);
+   /** Counts the records subscribed to each asyn parameters I/O Intr updates and marks which polled tags are needed by at least one
+    * of them. Runs at most once per second, when an on_demand poller starts a cycle */
+   void refreshDemand();
+   /** Returns false if pPoller is an on_demand poller and no subscribed record needs the tag used by drvUser */
+   bool tagDemanded(const omronEIPPoller *pPoller, const omronDrvUser_t *drvUser);
+   /** Returns true if pPoller should read and decode the tag used by drvUser on its current cycle. Takes into account on_demand
+    * pollers and tags with poll_every set */
+   bool tagDue(const omronEIPPoller *pPoller, const omronDrvUser_t *drvUser);
+   /** Waits for the bandwidth budget set with drvOmronEIPConfigBandwidth before a read of tagIndex is sent. Returns false if the budget
+    * did not allow the read before the pollers next deadline, in which case the tag is skipped for this cycle */
+   bool admitRead(omronEIPPoller *pPoller, int32_t tagIndex);
+   /** Returns true if the tag used by drvUser is due on this cycle and its read was not skipped by admitRead() */
+   bool decodeDue(const omronEIPPoller *pPoller, const omronDrvUser_t *drvUser);
+   /** Creates the token bucket which limits the bandwidth used by all of the drivers pollers */
+   asynStatus createBandwidthLimit(double bytesPerSec, double requestsPerSec);
+   /** Enables asynchronous writes and the write coalescing window, must be called before iocInit */
+   asynStatus configureWrites(int asyncWrites, double coalesceWindow);
+   /** Used by sendWrite() when a coalescing window is set or the last write of tagIndex is still in flight. Adds the parameter to the 
+    * writes queued for tagIndex, the first write starts the window. The values are already in the tag buffer, so later writes to 
+    * the same tag are merged with them */
+   asynStatus queueWrite(asynUser *pasynUser, int32_t tagIndex, const char *functionName);
+   /** Called by writeFlusher() with the port locked. Sends the writes queued for tagIndex as one write. If the last write of the tag
+    * is still in flight it has timed out, so it is aborted instead and the queued writes are sent once the abort is reported */
+   void flushWrites(int32_t tagIndex);
+   /** Used by issueReads(). Returns false if writes to tagIndex are waiting to be sent, the read is then skipped so that its reply
+    * cannot overwrite them and the tag is not decoded this cycle */
+   bool readAllowed(int32_t tagIndex);
+   /** Sends a read request for tagIndex without waiting for the reply. If asynchronous writes are enabled, the read is checked against
+    * the queued writes again under writeLock_ and skipped with PLCTAG_ERR_BUSY if one was queued after readAllowed() */
+   int sendRead(int32_t tagIndex);
+   /** Used by the write overrides once the new values are in the tag buffer. Sends the write and waits for the reply. If 
+    * asynchronous writes are enabled, the reply is waited for without the port lock and writeCompleted() reports the result. With
+    * a coalescing window the write is only queued, and the record completes before it is sent */
+   asynStatus sendWrite(asynUser *pasynUser, omronDrvUser_t *drvUser, const char *functionName);
+   /** Used by sendWrite() with the port locked. Unlocks the port until every write of tagIndex which has been sent or queued has 
+    * finished, and returns the status of the last one. If they take longer than the records timeout the write is aborted */
+   asynStatus waitForWrite(asynUser *pasynUser, int32_t tagIndex, const char *functionName);
+   /** Runs on writeCompletions_ when an asynchronous write of tagIndex finishes. Sets the status and alarm of the parameters 
+    * which were written and does their callbacks */
+   void writeCompleted(int32_t tagIndex, int status, const std::vector<int> &writeParams);
+   /** Gives each poller with phase_offset=auto an offset of i/N of its own interval, where it is the i'th of N such pollers. This stops
+    * pollers with related intervals from sending their requests at the same time */
+   void assignPhaseOffsets();
+   /** Chooses the pollPhase of each tag on pPoller with poll_every set, so that each cycle reads a similar number of tags */
+   void staggerPollPhases(omronEIPPoller *pPoller);
+   /** Used by issueReads() when spreadRequests_ is 2 or the poller has a maxInFlight_ window. Waits until the poller has fewer requests 
+    * in flight than its limit before sending the read request for tagIndex */
+   void issuePacedRead(omronEIPPoller *pPoller, int32_t tagIndex);
+   /** Waits for and decodes the reads of one cycle of a poller, updates the pollers statistics and moves it on to its next deadline */
+   void processReads(omronEIPPoller *pPoller);
+   /** Used by processReads() and decodeInParallel(). Waits until the read of drvUsers tag has finished or its timeout has passed since
+    * waitStartTime. A read which is still pending afterwards is reported as timed out by readData() */
+   void waitForRead(omronEIPPoller *pPoller, omronDrvUser_t *drvUser, std::chrono::steady_clock::time_point waitStartTime);
+   /** Returns the timestamp which parameters decoded from tagIndex are published with. This is the value of the tags plc_timestamp
+    * parameter if it has one, otherwise the time at which the last reply for the tag arrived, or the current time if none has */
+   epicsTimeStamp tagTimeStamp(int32_t tagIndex);
+   /** Does the callbacks for the parameters which have been updated so far, so that they keep their timestamp, and then sets the 
+    * port timestamp which the following updates are published with. If updates is given this is added to updates instead */
+   asynStatus publishTimeStamp(omronUpdateList *updates, const epicsTimeStamp &stamp);
+   /** Switches the driver to use a single scheduler thread and a pool of workerThreads for all of its pollers. Must be called before 
+    * any pollers are created */
+   asynStatus createScheduler(int workerThreads);
    /** Each record which is registered with a named poller will call the readData function with its asynIndex
-    * and drvUser. It waits for previously requested reads to come in and then takes the data from libplctag and puts it into records */
-   void readData(omronDrvUser_t* drvUser, int asynIndex);
-   /** Creates a new instance of the omronEIPPoller class and starts a new thread named after this new poller which reads data linked to the poller name.*/
-   asynStatus createPoller(const char * portName, const char * pollerName, double updateRate, int spreadRequests);
+    * and drvUser. It waits for previously requested reads to come in and then takes the data from libplctag and puts it into records.
+    * If pPoller is given, the caller must already have waited for the read to finish with waitForRead() and a read which is still 
+    * pending is treated as timed out. If updates is given, readData is running on a decode worker and the asyn parameter updates are 
+    * added to updates instead of being made */
+   void readData(omronDrvUser_t* drvUser, int asynIndex, omronEIPPoller* pPoller = NULL, omronUpdateList *updates = NULL);
+   /** Used when decode workers are configured. Waits for all of the pollers reads to finish, decodes its parameters in chunks on the 
+    * decode workers and then applies all of the asyn parameter updates together under the port lock.
+    * The workers do not hold the port lock, so readData() must not touch the asynPortDriver parameters when updates is given. Besides 
+    * libplctag and asynPrint, which are thread safe, the workers only use:
+    * - the drvUser being decoded. Each drvUser has one entry in one pollers decodeList_, so no other thread decodes it at the same time.
+    *   Its configuration is not changed after optimiseTags()
+    * - tagStates_, which is not written after the pollers start except for its atomic fields
+    * - timezoneOffset_, which is set in the constructor */
+   void decodeInParallel(omronEIPPoller *pPoller);
+   /** Creates the pool of decode workers used by decodeInParallel(), each worker decodes chunkSize parameters at a time */
+   asynStatus createDecodeWorkers(int workerThreads, int chunkSize);
+   /** Used by readData() to update asyn parameters. If updates is NULL the update is made straight away, otherwise it is added to
+    * updates to be made later by decodeInParallel(). Arrays are copied when the update is deferred */
+   asynStatus publishInteger(omronUpdateList *updates, int asynIndex, epicsInt32 value);
+   asynStatus publishInteger64(omronUpdateList *updates, int asynIndex, epicsInt64 value);
+   asynStatus publishDouble(omronUpdateList *updates, int asynIndex, epicsFloat64 value);
+   asynStatus publishString(omronUpdateList *updates, int asynIndex, const char *value);
+   asynStatus publishUIntDigital(omronUpdateList *updates, int asynIndex, epicsUInt32 value, epicsUInt32 valueMask, epicsUInt32 interruptMask);
+   template <typename epicsType>
+   asynStatus publishArray(omronUpdateList *updates, asynStatus (asynPortDriver::*doCallbacks)(epicsType *, size_t, int, int),
+                           epicsType *value, size_t nElements, int asynIndex);
+   /** Used by readData() for SINT, INT, DINT, USINT, UINT, UDINT, REAL and LREAL. Gets sliceSize values of type T from the snapshot
+    * and publishes them as a single value, or as an array of epicsType through doCallbacks */
+   template <typename T, typename epicsType>
+   asynStatus decodeNumeric(omronDrvUser_t *drvUser, int asynIndex, omronUpdateList *updates,
+                            asynStatus (asynPortDriver::*doCallbacks)(epicsType *, size_t, int, int));
+   /** Sets the status of the asyn parameter. If alarmSeverity is given, the alarm status is also set to status with this severity */
+   void publishStatus(omronUpdateList *updates, int asynIndex, asynStatus status, int alarmSeverity = -1);
+   /** Copies the bytes of the tag which drvUser is decoded from into bytes, the tag must be locked by the caller. The copy starts at
+    * tagOffset, or at tagOffset/8 for BOOL, and runs for the size of the slice or to the end of the tag for WORD and UDT types */
+   int takeSnapshot(omronDrvUser_t *drvUser, std::vector<uint8_t> &bytes);
+   /** Used by readData() for BOOL parameters of up to 32 bools which are packed 8 to a byte. Returns count bools starting at bit 
+    * firstBit of bytes, with the first bool in bit 0. This matches the bit offsets written by boolBitOffset() */
+   static epicsUInt32 gatherBits(const uint8_t *bytes, int firstBit, int count);
+   /** Used by readData() for parameters with publishOnChange set. Compares the raw bytes which the parameter is decoded from with
+    * the bytes from the last update and stores them. Returns true if they have changed. Uses drvUser->snapshot, except for STRING
+    * parameters which are decoded straight from the tag and must be locked by the caller */
+   bool rawDataChanged(omronDrvUser_t *drvUser);
+   /** Used by readData() for single numeric parameters. Returns true if value is within the parameters deadband of the last published
+    * value and should not be published. Otherwise value is stored as the last published value and false is returned */
+   bool withinDeadband(omronDrvUser_t *drvUser, double value);
+   /** Called by libplctag from its own thread when an event occurs on a tag which is read by a poller. Wakes up any pollers which
+    * are waiting for the tag to finish reading */
+   void tagCallback(int32_t tagIndex, int event, int status);
+   /** Creates a new instance of the omronEIPPoller class and starts a new thread named after this new poller which reads data linked to the poller name.
+    * pollerOptions is an optional string of &option=value pairs which is parsed by omronUtilities::pollerOptionsParser */
+   asynStatus createPoller(const char * portName, const char * pollerName, double updateRate, int spreadRequests, const char * pollerOptions = NULL);
    /** Reimplemented from asynDriver. This is called when each record is loaded into epics. It processes the drvInfo from the record and attempts
       to create a libplctag tag and an asynParameter. It saves the handles to these key objects within the tagMap_. This tagMap_ is then used to
       process read and write requests to the driver.*/
@@ -164,6 +442,11 @@ public:
    asynStatus createOptimisedTags(std::unordered_map<std::string, int> &structIDMap, optimiseMap const commonStructMap, std::unordered_map<int, std::string> &structTagMap);
    /** Now that the new tags have been created, we must link them to the correct asynParamater within tagMap_ and update other details*/
    asynStatus updateOptimisedParams(std::unordered_map<std::string, int> const structIDMap, optimiseMap const commonStructMap, std::unordered_map<int, std::string> const structTagMap);
+   /** Called once the tagMap_ is final. Fills each pollers readList_ and decodeList_ with the asyn parameters which it is responsible for */
+   asynStatus buildPollerLists();
+   /** Called once the tagMap_ is final. Registers a libplctag callback for every polled tag so that pollers are signalled as soon as
+      their reads complete. If asynchronous writes are enabled, every tag gets a callback so that writeCompleted() is run */
+   asynStatus registerReadCallbacks();
 
    /** Takes a csv style file, where each line contains a structure name followed by a list of datatypes within the struct
    Stores the user input struct as a map containing Struct:field_list pairs. It then calls createStructMap and passes this map */   
@@ -176,6 +459,7 @@ public:
    asynStatus writeInt8Array(asynUser *pasynUser, epicsInt8 *value, size_t nElements)override;
    asynStatus writeInt16Array(asynUser *pasynUser, epicsInt16 *value, size_t nElements)override;
    asynStatus writeInt32Array(asynUser *pasynUser, epicsInt32 *value, size_t nElements)override;
+   asynStatus writeInt64Array(asynUser *pasynUser, epicsInt64 *value, size_t nElements)override;
    asynStatus writeFloat32Array(asynUser *pasynUser, epicsFloat32 *value, size_t nElements)override;
    asynStatus writeFloat64Array(asynUser *pasynUser, epicsFloat64 *value, size_t nElements)override;
 
@@ -185,6 +469,9 @@ public:
    asynStatus writeFloat64(asynUser *pasynUser, epicsFloat64 value)override;
    asynStatus writeOctet(asynUser *pasynUser, const char * value, size_t nChars, size_t* nActual)override;
 
+   /** Reimplemented from asynPortDriver. Prints the timing statistics of each poller */
+   void report(FILE *fp, int details)override;
+
    /** Helper function used by some tests to get a drvUser */
    omronDrvUser_t* getDrvUser(int asynIndex);
 
@@ -200,6 +487,54 @@ private:
    /** Maps the index of each registered asynParameter to essential communications data for the parameter */
    std::unordered_map<int, omronDrvUser_t*> tagMap_;
    std::unordered_map<std::string, omronEIPPoller*> pollerList_ = {}; // Stores the name of each registered poller
+   /** Only used in scheduler mode, runs the decode part of each poller cycle. NULL if each poller has its own thread */
+   omronWorkerPool *workerPool_;
+   /** Shared by all pollers to limit the load on the PLC, NULL if there is no limit */
+   omronTokenBucket *bandwidth_;
+   /** If true, the write overrides do not wait for the PLC to reply. Set with drvOmronEIPConfigWrites */
+   bool asyncWrites_;
+   /** Runs writeCompleted() so that libplctags callback thread never waits for the port lock, NULL unless asyncWrites_ is set */
+   omronWorkerPool *writeCompletions_;
+   /** Protects the writeParams and queued writes of each tag state, and queuedTags_ */
+   epicsMutexId writeLock_;
+   /** Writes to the same tag within this many seconds are sent together, 0 sends each write straight away unless the last write of
+    * the tag is still in flight */
+   double coalesceWindow_;
+   /** Tags with writes waiting in the coalescing window */
+   std::vector<int32_t> queuedTags_;
+   /** Wakes writeFlusher() when a tag starts a new window or a write finishes while more writes to its tag are queued */
+   epicsEventId flushWake_;
+   /** Signalled by writeCompleted() to wake the write override waiting in waitForWrite() */
+   epicsEventId writeDone_;
+   /** Signalled when writeFlusher() exits, so that the destructor can wait for it. NULL if asynchronous writes are disabled */
+   epicsEventId writeFlusherExited_;
+   /** Statistics of asynchronous writes printed by report() */
+   std::atomic<size_t> asyncWritesSent_;
+   std::atomic<size_t> asyncWritesFailed_;
+   std::atomic<size_t> coalescedWrites_;
+   /** Protects lastDemandRefresh_ and refreshDemand() */
+   epicsMutexId demandLock_;
+   /** Time at which refreshDemand() last counted the subscribers */
+   std::chrono::steady_clock::time_point lastDemandRefresh_;
+   /** Decodes chunks of a pollers parameters in parallel, NULL if readData() runs on the poller thread */
+   omronWorkerPool *decodePool_;
+   /** The number of parameters decoded by each decode job */
+   size_t decodeChunkSize_;
+   /** Min-heap of pollers waiting for their next deadline, only used in scheduler mode. Pollers are removed while a cycle is running */
+   std::vector<omronEIPPoller*> schedulerQueue_;
+   /** Protects schedulerQueue_ */
+   epicsMutexId schedulerLock_;
+   /** Pollers which sent their requests from a worker and are waiting for the scheduler to collect their replies, protected by 
+    * schedulerLock_ */
+   std::vector<omronEIPPoller*> sentPollers_;
+   /** Wakes the scheduler thread when a poller is returned to schedulerQueue_ or sentPollers_, or one of its reads completes */
+   epicsEventId schedulerWake_;
+   /** Signalled when the scheduler thread exits, so that the destructor can wait for it. NULL if there is no scheduler thread */
+   epicsEventId schedulerExited_;
+   /** Maps each polled libplctag tag index to the pollers which must be woken up when a read of the tag completes, and the state of 
+      the tags last read request. The map is only written before the pollers start, so it can be read from the libplctag callback 
+      thread without locking */
+   std::unordered_map<int32_t, omronTagState_t> tagStates_;
    /** The key is the name of the struct, the vector is a list of byte offsets within the structure */
    std::unordered_map<std::string, std::vector<int>> structMap_;
    /** The key is the name of the struct, the vector contains strings representing the dtypes and embbed structs/arrays. 
@@ -222,6 +557,120 @@ class omronEIPPoller{
       double updateRate_;
       int spreadRequests_;
       int myTagCount_;
+      /** What to do when a cycle takes longer than updateRate_ */
+      omronOverrunPolicy_t overrunPolicy_;
+      /** Time in seconds from when the pollers start until the first cycle of this poller */
+      double phaseOffset_;
+      /** If true, phaseOffset_ is chosen by drvOmronEIP::assignPhaseOffsets() */
+      bool autoPhase_;
+      /** Start time of the first cycle, cycle n is due at phaseReference_ + n*updateRate_ */
+      std::chrono::steady_clock::time_point phaseReference_;
+      /** The number of the next cycle counted from phaseReference_, used to calculate nextDeadline_ without accumulating drift */
+      int64_t nextCycle_;
+      /** Time at which the next cycle should start */
+      std::chrono::steady_clock::time_point nextDeadline_;
+      /** Time at which the current cycle actually started */
+      std::chrono::steady_clock::time_point cycleStartTime_;
+      /** Scheduler mode. Time at which the last read request of the current cycle was sent, read timeouts are measured from here */
+      std::chrono::steady_clock::time_point readsSentTime_;
+      /** Scheduler mode. The position in decodeList_ up to which drvOmronEIP::repliesArrived() has found the reads finished */
+      size_t repliesChecked_;
+      /** Statistics printed by drvOmronEIP::report() */
+      size_t cycleCount_;
+      size_t overrunCount_;
+      size_t skippedCycles_;
+      double lastCycleTime_;
+      double maxCycleTime_;
+      /** Sets the start of the pollers schedule, the first cycle is due phaseOffset_ seconds after now */
+      void startSchedule(std::chrono::steady_clock::time_point now);
+      /** Moves nextDeadline_ on to the next cycle according to overrunPolicy_. Returns true if the cycle which just finished overran */
+      bool scheduleNextCycle(std::chrono::steady_clock::time_point now);
+      /** Parameters which this poller sends read requests for, one per libplctag tag */
+      std::vector<omronPollEntry_t> readList_;
+      /** Parameters which this poller decodes and updates each cycle, sorted so that parameters sharing a tag are next to each other */
+      std::vector<omronPollEntry_t> decodeList_;
+      /** Signalled from tagCallback() whenever a read of one of this pollers tags completes or is aborted */
+      epicsEventId readComplete_;
+      /** Signalled by the last decode worker to finish a chunk of this pollers parameters */
+      epicsEventId decodeDone_;
+      /** Signalled when this pollers readPoller() thread exits, NULL in scheduler mode where there is no such thread */
+      epicsEventId threadExited_;
+      /** Adaptive pacing (spreadRequests_ == 2). The number of read requests which are waiting for a reply */
+      std::atomic<int> inFlight_;
+      /** Adaptive pacing. The number of requests we allow to be in flight, grown while the PLC keeps up and halved when it does not */
+      double targetInFlight_;
+      /** Adaptive pacing. Moving average of the time between sending a read request and its reply */
+      double rttEstimate_;
+      /** The most requests which may be in flight at once, set with the max_in_flight poller option. 0 means no limit */
+      int maxInFlight_;
+      /** Counts the cycles in which the poller has sent read requests, used for tags with poll_every set */
+      int64_t readCycle_;
+      /** Used when the bandwidth is limited, pollers with a higher priority are allowed to send their requests first */
+      int priority_;
+      /** The number of reads which were skipped because the bandwidth budget was used up */
+      size_t budgetSkips_;
+      /** If true, the poller skips tags which have no subscribed records, set with the on_demand poller option */
+      bool onDemand_;
+      /** Window statistics printed by drvOmronEIP::report(). The number of requests sent through the window, the sum of the number of
+       *  requests already in flight when each was sent, and the number of times a request had to wait for the window to open */
+      size_t windowRequests_;
+      size_t windowOccupancySum_;
+      size_t windowFullCount_;
+      /** The number of reads deferred to the next cycle because the window stayed full for longer than updateRate_ */
+      size_t windowSkips_;
+      /** Adaptive pacing. Protects targetInFlight_ and rttEstimate_ which are updated from the libplctag callback thread */
+      epicsMutexId pacingLock_;
+      /** Called from tagCallback() when an adaptively paced read finishes, updates the round trip time and the target in flight depth */
+      void pacedReadFinished(double roundTripTime, bool success);
+};
+
+/** Limits the rate of read requests sent to one PLC, in both bytes and requests per second. Readers wait until there are tokens in
+ *  both buckets. If several readers are waiting, the one with the highest priority goes first, then the one with the shortest interval */
+class omronTokenBucket{
+  public:
+      omronTokenBucket(double bytesPerSec, double requestsPerSec);
+      ~omronTokenBucket();
+      /** Waits until a request for bytes can be sent, or until timeout seconds have passed. Returns true if the request may be sent */
+      bool acquire(int priority, double updateRate, double bytes, double timeout);
+      /** Limits set with drvOmronEIPConfigBandwidth, 0 means no limit */
+      const double bytesPerSec_;
+      const double requestsPerSec_;
+      /** Statistics printed by drvOmronEIP::report(), which reads them without bucketLock_ */
+      std::atomic<size_t> admittedRequests_;
+      std::atomic<size_t> admittedBytes_;
+      std::atomic<size_t> rejectedRequests_;
+  private:
+      /** Adds the tokens earned since the last refill, must be called with bucketLock_ held */
+      void refill();
+      /** Tokens can go negative when a large request is admitted, the debt is repaid before the next request is admitted */
+      double byteTokens_;
+      double requestTokens_;
+      std::chrono::steady_clock::time_point lastRefill_;
+      /** Priorities of the readers which are waiting, as (priority, -updateRate) so that the largest is served first */
+      std::multiset<std::pair<int, double>> waiting_;
+      epicsMutexId bucketLock_;
+};
+
+/** A fixed number of threads which run jobs from a shared queue, in the order that they were submitted */
+class omronWorkerPool{
+  public:
+      omronWorkerPool(const char* poolName, int threadCount);
+      /** Lets the workers finish every job which is still queued, then waits for the worker threads to exit */
+      ~omronWorkerPool();
+      /** Adds a job to the queue, it will be run by the first free worker */
+      void submit(std::function<void()> job);
+      /** The loop run by each worker thread */
+      void workerLoop();
+      const int threadCount_;
+  private:
+      std::deque<std::function<void()>> jobs_;
+      /** Protects jobs_, exiting_ and runningThreads_ */
+      epicsMutexId jobsLock_;
+      epicsEventId jobsAvailable_;
+      /** Signalled by each worker thread as it exits */
+      epicsEventId threadsExited_;
+      bool exiting_;
+      int runningThreads_;
 };
 
 #endif
\ No newline at end of file
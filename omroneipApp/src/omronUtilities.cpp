@@ -93,6 +93,8 @@ std::tuple<std::string,std::string> omronUtilities::checkValidExtras(std::string
 
     // look for and process the strings: str_max_capacity, offset_read_size and as_time
     processExtrasExceptions(str, keyWords, extrasString, defaultTagAttribs);
+    if (keyWords.at("stringValid") != "true")
+      stringValid = "false";
 
     for (auto &attrib : defaultTagAttribs)
     {
@@ -261,7 +263,7 @@ std::tuple<std::string,std::string> omronUtilities::checkValidSliceSize(const st
       if (indexable && str != "1")
       {
         sliceSize = str;
-        if (dtype=="STRING" || dtype=="LINT" || dtype=="ULINT"){
+        if (dtype=="STRING"){
           asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, sliceSize must be 1 for this datatype.\n", driverName, functionName);
           stringValid = "false";
           sliceSize = "1";
@@ -380,7 +382,12 @@ drvInfoMap omronUtilities::drvInfoParser(const char *drvInfo)
       {"stringValid", "true"}, // set to false if errors are detected which aborts creation of tag and asyn parameter, return early if false
       {"offsetReadSize", "0"},
       {"readAsString", "0"}, // currently just used to optionally output the TIME dtypes as user friendly strings in the local timezone
-      {"optimise", "0"} // if 0 then we use the offset to look within a datatype, if 1 then we use it to get a datatype from within an array/UDT
+      {"timeDecimals", "0"}, // the number of digits after the seconds when a TIME is output as a string
+      {"optimise", "0"}, // if 0 then we use the offset to look within a datatype, if 1 then we use it to get a datatype from within an array/UDT
+      {"publishOnChange", "0"}, // if 1 then the poller only updates the asyn parameter when its raw bytes have changed
+      {"deadband", "0"}, // the poller only updates a numeric parameter when it changes by more than this, either absolute or a percentage eg "5%"
+      {"pollEvery", "1"}, // the tag is only read on every Nth cycle of its poller
+      {"plcTimestamp", "0"} // if 1 then this TIME value is used as the timestamp of every parameter decoded from the same tag
   };
   asynPrint(pasynUserSelf, ASYN_TRACE_FLOW, "============================================================================================\n");
   std::list<std::string> words; // Contains a list of string parameters supplied by the user through a record's drvInfo interface.
@@ -558,6 +565,31 @@ void omronUtilities::processExtrasExceptions(std::string thisWord, drvInfoMap &k
     }
   }
 
+  // we check to see if time_decimals= is defined, this is only used by the driver when a TIME is read as a string
+  if (takeExtra(thisWord, extrasString, "time_decimals", size))
+  {
+    if (keyWords.at("dataType") != "TIME")
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, time_decimals= should only be set for TIME type.\n", 
+                  driverName, functionName);
+    }
+    else
+    {
+      try
+      {
+        int decimals = wholeInt(size);
+        if (decimals < 0 || decimals > 9)
+          throw std::invalid_argument(size);
+        keyWords.at("timeDecimals") = std::to_string(decimals);
+      }
+      catch(...){
+        keyWords.at("stringValid") = "false";
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid value for time_decimals=: %s. Expected an integer from 0 to 9\n", 
+                    driverName, functionName, size.c_str());
+      }
+    }
+  }
+
   // we check to see if &optimise= is defined. This is a bit different as it is not used in libplctag, so is removed from extrasString
   pos = thisWord.find("optimise=");
   if (pos != std::string::npos)
@@ -594,6 +626,83 @@ void omronUtilities::processExtrasExceptions(std::string thisWord, drvInfoMap &k
     }
   }
 
+  // we check to see if publish_on_change= is defined, this is only used by the driver
+  if (takeExtra(thisWord, extrasString, "publish_on_change", size))
+  {
+    try
+    {
+      keyWords.at("publishOnChange") = std::to_string(wholeInt(size));
+    }
+    catch(...){
+      keyWords.at("stringValid") = "false";
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid value for publish_on_change=: %s\n", driverName, functionName, size.c_str());
+    }
+  }
+
+  // we check to see if deadband= is defined, this is only used by the driver and only makes sense for single numeric values
+  if (takeExtra(thisWord, extrasString, "deadband", size))
+  {
+    const std::vector<std::string> numericTypes = {"SINT", "INT", "DINT", "LINT", "USINT", "UINT", "UDINT", "ULINT", "REAL", "LREAL"};
+    if (std::find(numericTypes.begin(), numericTypes.end(), keyWords.at("dataType")) == numericTypes.end() || keyWords.at("sliceSize") != "1")
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, deadband= should only be set for single integer or floating point values.\n", 
+                  driverName, functionName);
+    }
+    else
+    {
+      try
+      {
+        std::string number = (!size.empty() && size.back() == '%') ? size.substr(0, size.size() - 1) : size;
+        size_t idx;
+        if (std::stod(number, &idx) < 0 || idx != number.size())
+          throw std::invalid_argument(size);
+        keyWords.at("deadband") = size;
+      }
+      catch(...){
+        keyWords.at("stringValid") = "false";
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid value for deadband=: %s. Expected a positive number or percentage\n", 
+                    driverName, functionName, size.c_str());
+      }
+    }
+  }
+
+  // we check to see if poll_every= is defined, this is only used by the driver
+  if (takeExtra(thisWord, extrasString, "poll_every", size))
+  {
+    try
+    {
+      int pollEvery = wholeInt(size);
+      if (pollEvery < 1)
+        throw std::invalid_argument(size);
+      keyWords.at("pollEvery") = std::to_string(pollEvery);
+    }
+    catch(...){
+      keyWords.at("stringValid") = "false";
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid value for poll_every=: %s. Expected an integer >= 1\n", driverName, functionName, size.c_str());
+    }
+  }
+
+  // we check to see if plc_timestamp= is defined, this is only used by the driver and only makes sense for a single TIME value
+  if (takeExtra(thisWord, extrasString, "plc_timestamp", size))
+  {
+    if (keyWords.at("dataType") != "TIME" || keyWords.at("sliceSize") != "1")
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_WARNING, "%s:%s Warn, plc_timestamp= should only be set for single TIME values.\n", 
+                  driverName, functionName);
+    }
+    else
+    {
+      try
+      {
+        keyWords.at("plcTimestamp") = std::to_string(wholeInt(size));
+      }
+      catch(...){
+        keyWords.at("stringValid") = "false";
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid value for plc_timestamp=: %s\n", driverName, functionName, size.c_str());
+      }
+    }
+  }
+
   // we check to see if str_max_capacity is set, this is needed to get strings from UDTs
   pos = thisWord.find("str_max_capacity=");
   if (keyWords.at("dataType")=="STRING"){
@@ -632,6 +741,136 @@ void omronUtilities::processExtrasExceptions(std::string thisWord, drvInfoMap &k
   }
 }
 
+bool omronUtilities::takeExtra(const std::string &thisWord, std::string &extrasString, const std::string &key, std::string &value)
+{
+  // Only match whole attributes, so that eg "xpoll_every=" is not taken for "poll_every=". The first attribute may be missing its &
+  std::string search = "&" + key + "=";
+  size_t pos = (thisWord.compare(0, search.size() - 1, search, 1, std::string::npos) == 0) ? 0 : thisWord.find(search);
+  if (pos == std::string::npos)
+    return false;
+  size_t start = pos + search.size() - (thisWord[pos] != '&');
+  size_t end = thisWord.find('&', start);
+  value = (end == std::string::npos) ? thisWord.substr(start) : thisWord.substr(start, end - start);
+
+  pos = (extrasString.compare(0, search.size() - 1, search, 1, std::string::npos) == 0) ? 0 : extrasString.find(search);
+  if (pos != std::string::npos)
+  {
+    end = extrasString.find('&', pos + 1);
+    if (end == std::string::npos)
+      end = extrasString.size();
+    extrasString.erase(pos, end - pos);
+  }
+  return true;
+}
+
+int omronUtilities::wholeInt(const std::string &value)
+{
+  size_t idx;
+  int number = std::stoi(value, &idx);
+  if (idx != value.size())
+    throw std::invalid_argument(value);
+  return number;
+}
+
+drvInfoMap omronUtilities::pollerOptionsParser(const char *pollerOptions)
+{
+  const char * functionName = "pollerOptionsParser";
+  drvInfoMap options = {
+      {"optionsValid", "true"}, // set to false if any option is not recognised or has an invalid value
+      {"overrun", "run_late"}, // what the poller does when a cycle overruns its deadline ("run_late", "skip" or "catch_up")
+      {"max_in_flight", "0"}, // the most read requests the poller keeps waiting for a reply at once, 0 means no limit
+      {"on_demand", "0"}, // if 1 then the poller only reads tags which have a record subscribed to their I/O Intr updates
+      {"phase_offset", "0"}, // delay in seconds before the first cycle, or "auto" to spread the pollers of the driver across their intervals
+      {"priority", "0"} // when the bandwidth is limited, pollers with a higher priority send their requests first
+  };
+  if (pollerOptions == NULL)
+  {
+    return options;
+  }
+
+  std::string optionsString = pollerOptions;
+  std::string option;
+  std::istringstream s(optionsString);
+  while (std::getline(s, option, '&'))
+  {
+    if (option.empty() || option == "none" || option == "0")
+      continue;
+    size_t pos = option.find('=');
+    std::string key = option.substr(0, pos);
+    std::string value = (pos == std::string::npos) ? "" : option.substr(pos + 1);
+    if (pos == std::string::npos || key == "optionsValid" || options.find(key) == options.end())
+    {
+      asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Unknown poller option: %s\n", driverName, functionName, option.c_str());
+      options.at("optionsValid") = "false";
+      continue;
+    }
+
+    if (key == "overrun")
+    {
+      if (value != "run_late" && value != "skip" && value != "catch_up")
+      {
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid value for overrun=: %s. Expected run_late, skip or catch_up\n", 
+                    driverName, functionName, value.c_str());
+        options.at("optionsValid") = "false";
+        continue;
+      }
+    }
+    else if (key == "on_demand")
+    {
+      if (value != "0" && value != "1")
+      {
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, Invalid value for on_demand=: %s. Expected 0 or 1\n", driverName, functionName, value.c_str());
+        options.at("optionsValid") = "false";
+        continue;
+      }
+    }
+    else if (key == "phase_offset" && value != "auto")
+    {
+      try
+      {
+        size_t idx;
+        if (std::stod(value, &idx) < 0 || idx != value.size())
+          throw std::invalid_argument(value);
+      }
+      catch(...)
+      {
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, phase_offset must be a positive number of seconds or auto: %s\n", driverName, functionName, value.c_str());
+        options.at("optionsValid") = "false";
+        continue;
+      }
+    }
+    else if (key == "priority")
+    {
+      try
+      {
+        wholeInt(value);
+      }
+      catch(...)
+      {
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, priority must be an integer: %s\n", driverName, functionName, value.c_str());
+        options.at("optionsValid") = "false";
+        continue;
+      }
+    }
+    else if (key == "max_in_flight")
+    {
+      try
+      {
+        if (wholeInt(value) < 0)
+          throw std::invalid_argument(value);
+      }
+      catch(...)
+      {
+        asynPrint(pasynUserSelf, ASYN_TRACE_ERROR, "%s:%s Err, max_in_flight must be a positive integer: %s\n", driverName, functionName, value.c_str());
+        options.at("optionsValid") = "false";
+        continue;
+      }
+    }
+    options.at(key) = value;
+  }
+  return options;
+}
+
 int omronUtilities::findRequestedOffset(std::vector<size_t> indices, std::string structName)
 {
   static const char *functionName = "findRequestedOffset";
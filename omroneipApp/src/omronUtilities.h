@@ -94,6 +94,13 @@ public:
       and updates extrasString and keyWords */
    void processExtrasExceptions(std::string thisWord, drvInfoMap &keyWords, std::string &extrasString, drvInfoMap &defaultTagAttribs);
 
+   /** Looks for &key=value within the extras thisWord. If found, value is set and the attribute is removed from extrasString as it is
+      only used by the driver and not by libplctag. Returns true if the key was found */
+   bool takeExtra(const std::string &thisWord, std::string &extrasString, const std::string &key, std::string &value);
+
+   /** Converts value to an int like std::stoi, but throws std::invalid_argument if there are characters left over, eg "8x" */
+   int wholeInt(const std::string &value);
+
    /** This is responsible for parsing drvInfo when records are created. It takes the drvInfo string and parses it for required data.
       It returns a map of all of the data required by the driver to setup the asyn parameter and a boolean which indicates the validity of the data. */
    drvInfoMap drvInfoParser(const char *drvInfo);
@@ -112,6 +119,10 @@ public:
    std::tuple<std::string,std::string> checkValidOffset(std::string str);
    /** Check that the user supplied extras string is valid, returns a tuple of stringValid and extrasString */
    std::tuple<std::string,std::string> checkValidExtras(std::string str, drvInfoMap &keyWords);
+
+   /** Parses the optional options string passed to drvOmronEIPConfigPoller, eg "&overrun=skip". Returns a map containing every
+      poller option, set to either the users value or the default. "optionsValid" is set to "false" if an option is unknown or invalid */
+   drvInfoMap pollerOptionsParser(const char *pollerOptions);
 };
 
 #endif
\ No newline at end of file
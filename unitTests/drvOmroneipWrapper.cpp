@@ -48,6 +48,11 @@ asynStatus drvOmronEIPWrapper::wrap_drvUserCreate(asynUser* pAsynUser, const cha
   return drvUserCreate(pAsynUser,drvInfo,pptypeName,psize);
 }
 
+epicsUInt32 drvOmronEIPWrapper::wrap_gatherBits(const uint8_t *bytes, int firstBit, int count)
+{
+  return gatherBits(bytes, firstBit, count);
+}
+
 drvOmronEIPWrapper::~drvOmronEIPWrapper()
 {
 }
@@ -18,6 +18,7 @@ public:
    void wrap_setAsynTrace(int mask);
    asynStatus wrap_optimiseTags();
    asynStatus wrap_drvUserCreate(asynUser *pAsynUser, const char *drvInfo);
+   static epicsUInt32 wrap_gatherBits(const uint8_t *bytes, int firstBit, int count);
 };
 
 class omronEIPPollerWrapper : public omronEIPPoller {
@@ -38,3 +38,9 @@ std::tuple<std::string, std::string> omronUtilitiesWrapper::wrap_checkValidExtra
 {
   return checkValidExtras(str, keyWords);
 }
+
+
+drvInfoMap omronUtilitiesWrapper::wrap_pollerOptionsParser(const char *pollerOptions)
+{
+  return pollerOptionsParser(pollerOptions);
+}
\ No newline at end of file
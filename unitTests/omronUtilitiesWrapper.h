@@ -15,6 +15,7 @@ public:
    std::tuple<std::string,std::string> wrap_checkValidSliceSize(const std::string str, bool indexable, std::string dtype);
    std::tuple<std::string,std::string> wrap_checkValidOffset(const std::string str);
    std::tuple<std::string,std::string> wrap_checkValidExtras(const std::string str, drvInfoMap &keyWords);
+   drvInfoMap wrap_pollerOptionsParser(const char *pollerOptions);
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "drvOmroneipWrapper.h"
 #include "omronUtilitiesWrapper.h"
 #include <boost/test/unit_test.hpp>
+#include <thread>
 
 class omronUtilitiesTestFixture
 {
@@ -60,7 +61,12 @@ class omronUtilitiesTestFixture
                 {"stringValid", "true"}, // set to false if errors are detected which aborts creation of tag and asyn parameter, return early if false
                 {"offsetReadSize", "0"},
                 {"readAsString", "0"}, // currently just used to optionally output the TIME dtypes as user friendly strings in the local timezone
-                {"optimise", "0"} // if 0 then we use the offset to look within a datatype, if 1 then we use it to get a datatype from within an array/UDT
+                {"timeDecimals", "0"}, // the number of digits after the seconds when a TIME is output as a string
+                {"optimise", "0"}, // if 0 then we use the offset to look within a datatype, if 1 then we use it to get a datatype from within an array/UDT
+                {"publishOnChange", "0"}, // if 1 then the poller only updates the asyn parameter when its raw bytes have changed
+                {"deadband", "0"}, // the poller only updates a numeric parameter when it changes by more than this, either absolute or a percentage eg "5%"
+                {"pollEvery", "1"}, // the tag is only read on every Nth cycle of its poller
+                {"plcTimestamp", "0"} // if 1 then this TIME value is used as the timestamp of every parameter decoded from the same tag
             };
         }
 
@@ -315,13 +321,24 @@ BOOST_AUTO_TEST_CASE(test_negative_checkValidSliceSize_NotIndexable)
     BOOST_CHECK_EQUAL(stringValid,"true");
 }
 
-BOOST_AUTO_TEST_CASE(test_negative_checkValidSliceSize_NonIndexableDtype)
+BOOST_AUTO_TEST_CASE(test_checkValidSliceSize_Int64Dtype)
 {
     std::string str = "123";
     bool indexable = true;
     std::string dtype = "LINT";
     std::cout << "Test string: " << str << " Test indexable: " << indexable << " Test dtype: " << dtype << std::endl;
     const auto [stringValid, sliceSize] = testUtilities->wrap_checkValidSliceSize(str,indexable,dtype);
+    BOOST_CHECK_EQUAL(sliceSize,"123");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_checkValidSliceSize_NonIndexableDtype)
+{
+    std::string str = "123";
+    bool indexable = true;
+    std::string dtype = "STRING";
+    std::cout << "Test string: " << str << " Test indexable: " << indexable << " Test dtype: " << dtype << std::endl;
+    const auto [stringValid, sliceSize] = testUtilities->wrap_checkValidSliceSize(str,indexable,dtype);
     BOOST_CHECK_EQUAL(sliceSize,"1");
     BOOST_CHECK_EQUAL(stringValid,"false");
 }
@@ -499,6 +516,166 @@ BOOST_AUTO_TEST_CASE(test_checkValidExtras_ReadAsString)
     BOOST_CHECK_EQUAL(stringValid,"true");
 }
 
+BOOST_AUTO_TEST_CASE(test_checkValidExtras_PublishOnChange)
+{
+    std::string str = "&publish_on_change=1";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "UDT";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(extrasString.find("publish_on_change"),std::string::npos);
+    BOOST_CHECK_EQUAL(keyWords.at("publishOnChange"),"1");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_checkValidExtras_PublishOnChange)
+{
+    std::string str = "&publish_on_change=yes";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "DINT";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("publishOnChange"),"0");
+    BOOST_CHECK_EQUAL(stringValid,"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_checkValidExtras_PublishOnChangeTrailing)
+{
+    std::string str = "&publish_on_change=1x";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "DINT";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("publishOnChange"),"0");
+    BOOST_CHECK_EQUAL(stringValid,"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_checkValidExtras_Deadband)
+{
+    std::string str = "&deadband=2.5%";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "REAL";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(extrasString,"&allow_packing=1");
+    BOOST_CHECK_EQUAL(keyWords.at("deadband"),"2.5%");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_checkValidExtras_Deadband2)
+{
+    //We request a deadband for an array which is not supported, this is ignored with a warning
+    std::string str = "&deadband=3";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "DINT";
+    keyWords.at("sliceSize") = "10";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("deadband"),"0");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_checkValidExtras_Deadband)
+{
+    std::string str = "&deadband=-1";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "LREAL";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("deadband"),"0");
+    BOOST_CHECK_EQUAL(stringValid,"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_checkValidExtras_PollEvery)
+{
+    std::string str = "&poll_every=10";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "DINT";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(extrasString,"&allow_packing=1");
+    BOOST_CHECK_EQUAL(keyWords.at("pollEvery"),"10");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_checkValidExtras_PollEvery)
+{
+    std::string str = "&poll_every=0";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "DINT";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("pollEvery"),"1");
+    BOOST_CHECK_EQUAL(stringValid,"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_checkValidExtras_PollEveryTrailing)
+{
+    std::string str = "&poll_every=10s";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "DINT";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("pollEvery"),"1");
+    BOOST_CHECK_EQUAL(stringValid,"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_checkValidExtras_PollEveryPartialName)
+{
+    //An attribute which only ends with poll_every is not taken by the driver, it is left for libplctag
+    std::string str = "&xpoll_every=10";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "DINT";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(extrasString,"&xpoll_every=10&allow_packing=1");
+    BOOST_CHECK_EQUAL(keyWords.at("pollEvery"),"1");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_checkValidExtras_TimeDecimals)
+{
+    std::string str = "&time_decimals=3";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "TIME";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(extrasString,"&allow_packing=1");
+    BOOST_CHECK_EQUAL(keyWords.at("timeDecimals"),"3");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_checkValidExtras_TimeDecimals)
+{
+    std::string str = "&time_decimals=10";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "TIME";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("timeDecimals"),"0");
+    BOOST_CHECK_EQUAL(stringValid,"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_checkValidExtras_PlcTimestamp)
+{
+    std::string str = "&plc_timestamp=1";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "TIME";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(extrasString,"&allow_packing=1");
+    BOOST_CHECK_EQUAL(keyWords.at("plcTimestamp"),"1");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_checkValidExtras_PlcTimestamp2)
+{
+    //We request a plc timestamp from a datatype which is not TIME, this is ignored with a warning
+    std::string str = "&plc_timestamp=1";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "LINT";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("plcTimestamp"),"0");
+    BOOST_CHECK_EQUAL(stringValid,"true");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_checkValidExtras_PlcTimestampTrailing)
+{
+    std::string str = "&plc_timestamp=1.5";
+    std::cout << "Test string: " << str << std::endl;
+    keyWords.at("dataType") = "TIME";
+    const auto [stringValid, extrasString] = testUtilities->wrap_checkValidExtras(str,keyWords);
+    BOOST_CHECK_EQUAL(keyWords.at("plcTimestamp"),"0");
+    BOOST_CHECK_EQUAL(stringValid,"false");
+}
+
 BOOST_AUTO_TEST_CASE(test_checkValidExtras_ReadAsString2)
 {
     //We request this extra for a "REAL" datatype which is not valid
@@ -527,6 +704,129 @@ BOOST_AUTO_TEST_CASE(test_checkValidExtras_AllExtras)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_FIXTURE_TEST_SUITE(pollerOptionsTests, omronUtilitiesTestFixture)
+
+BOOST_AUTO_TEST_CASE(test_pollerOptionsParser_Defaults)
+{
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(NULL);
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"true");
+    BOOST_CHECK_EQUAL(options.at("overrun"),"run_late");
+    BOOST_CHECK_EQUAL(options.at("max_in_flight"),"0");
+    BOOST_CHECK_EQUAL(options.at("on_demand"),"0");
+    BOOST_CHECK_EQUAL(options.at("phase_offset"),"0");
+    BOOST_CHECK_EQUAL(options.at("priority"),"0");
+}
+
+BOOST_AUTO_TEST_CASE(test_pollerOptionsParser_Overrun)
+{
+    std::string str = "&overrun=skip";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"true");
+    BOOST_CHECK_EQUAL(options.at("overrun"),"skip");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_pollerOptionsParser_BadOverrun)
+{
+    std::string str = "&overrun=sometimes";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_pollerOptionsParser_MaxInFlight)
+{
+    std::string str = "&max_in_flight=8&overrun=skip";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"true");
+    BOOST_CHECK_EQUAL(options.at("max_in_flight"),"8");
+    BOOST_CHECK_EQUAL(options.at("overrun"),"skip");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_pollerOptionsParser_BadMaxInFlight)
+{
+    std::string str = "&max_in_flight=-2";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"false");
+    BOOST_CHECK_EQUAL(options.at("max_in_flight"),"0");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_pollerOptionsParser_MaxInFlightTrailing)
+{
+    std::string str = "&max_in_flight=8x";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"false");
+    BOOST_CHECK_EQUAL(options.at("max_in_flight"),"0");
+}
+
+BOOST_AUTO_TEST_CASE(test_pollerOptionsParser_OnDemand)
+{
+    std::string str = "&on_demand=1";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"true");
+    BOOST_CHECK_EQUAL(options.at("on_demand"),"1");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_pollerOptionsParser_BadOnDemand)
+{
+    std::string str = "&on_demand=sometimes";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_pollerOptionsParser_PhaseOffset)
+{
+    std::string str = "&phase_offset=0.25";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"true");
+    BOOST_CHECK_EQUAL(options.at("phase_offset"),"0.25");
+    options = testUtilities->wrap_pollerOptionsParser("&phase_offset=auto");
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"true");
+    BOOST_CHECK_EQUAL(options.at("phase_offset"),"auto");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_pollerOptionsParser_BadPhaseOffset)
+{
+    std::string str = "&phase_offset=0.25s";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_pollerOptionsParser_Priority)
+{
+    std::string str = "&priority=-2&overrun=skip";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"true");
+    BOOST_CHECK_EQUAL(options.at("priority"),"-2");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_pollerOptionsParser_BadPriority)
+{
+    std::string str = "&priority=high";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"false");
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_pollerOptionsParser_UnknownOption)
+{
+    std::string str = "&overrun=catch_up&colour=blue";
+    std::cout << "Test string: " << str << std::endl;
+    drvInfoMap options = testUtilities->wrap_pollerOptionsParser(str.c_str());
+    BOOST_CHECK_EQUAL(options.at("overrun"),"catch_up");
+    BOOST_CHECK_EQUAL(options.at("optionsValid"),"false");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_FIXTURE_TEST_SUITE(importStructDefsTests, omronUtilitiesTestFixture)
 
 BOOST_AUTO_TEST_CASE(test_importFile)
@@ -534,4 +834,87 @@ BOOST_AUTO_TEST_CASE(test_importFile)
     BOOST_CHECK(true);
 }
 
-BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
+BOOST_AUTO_TEST_SUITE_END()
+
+extern bool omronExiting;
+
+class bandwidthTestFixture
+{
+    public:
+        bandwidthTestFixture()
+        {
+            // Destroying the drivers of the earlier tests sets omronExiting, which makes the bucket turn every waiter away
+            omronExiting = false;
+        }
+};
+
+BOOST_FIXTURE_TEST_SUITE(bandwidthTests, bandwidthTestFixture)
+
+/* Both waiters are blocked on an empty bucket before the next token arrives, returns the order in which they were admitted */
+static std::pair<int, int> admissionOrder(int firstPriority, double firstRate, int secondPriority, double secondRate)
+{
+    omronTokenBucket bucket(0, 5); // one request every 0.2 seconds, the bucket holds at most one
+    std::atomic<int> admitted(0);
+    int firstOrder = 0, secondOrder = 0;
+    BOOST_REQUIRE(bucket.acquire(0, 1, 0, 1)); // take the first token so that both waiters have to wait
+    std::thread first([&]() { if (bucket.acquire(firstPriority, firstRate, 0, 2)) firstOrder = ++admitted; });
+    epicsThreadSleep(0.05);
+    std::thread second([&]() { if (bucket.acquire(secondPriority, secondRate, 0, 2)) secondOrder = ++admitted; });
+    first.join();
+    second.join();
+    return std::make_pair(firstOrder, secondOrder);
+}
+
+BOOST_AUTO_TEST_CASE(test_tokenBucket_Priority)
+{
+    // The low priority poller starts waiting first, but the high priority poller takes the next token
+    std::pair<int, int> order = admissionOrder(0, 1, 5, 1);
+    BOOST_CHECK_EQUAL(order.second, 1);
+    BOOST_CHECK_EQUAL(order.first, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_tokenBucket_FastestFirst)
+{
+    // With equal priorities the poller with the shorter interval goes first
+    std::pair<int, int> order = admissionOrder(0, 1, 0, 0.1);
+    BOOST_CHECK_EQUAL(order.second, 1);
+    BOOST_CHECK_EQUAL(order.first, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_negative_tokenBucket_Timeout)
+{
+    // A request which cannot be admitted within its timeout is rejected
+    omronTokenBucket bucket(0, 5);
+    BOOST_REQUIRE(bucket.acquire(0, 1, 0, 1));
+    BOOST_CHECK(!bucket.acquire(0, 1, 0, 0.05));
+    BOOST_CHECK_EQUAL(bucket.rejectedRequests_.load(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(boolTests)
+
+BOOST_AUTO_TEST_CASE(test_gatherBits_Aligned)
+{
+    const uint8_t bytes[] = {0xA5, 0x3C};
+    BOOST_CHECK_EQUAL(drvOmronEIPWrapper::wrap_gatherBits(bytes, 0, 1), 1u);
+    BOOST_CHECK_EQUAL(drvOmronEIPWrapper::wrap_gatherBits(bytes, 0, 16), 0x3CA5u);
+}
+
+BOOST_AUTO_TEST_CASE(test_gatherBits_Unaligned)
+{
+    // The bools start at bit 4 of the first byte, so the slice takes the top half of the first byte and the bottom half of the next
+    const uint8_t bytes[] = {0xB0, 0x05};
+    BOOST_CHECK_EQUAL(drvOmronEIPWrapper::wrap_gatherBits(bytes, 4, 8), 0x5Bu);
+    BOOST_CHECK_EQUAL(drvOmronEIPWrapper::wrap_gatherBits(bytes, 5, 1), 1u);
+    BOOST_CHECK_EQUAL(drvOmronEIPWrapper::wrap_gatherBits(bytes, 6, 1), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_gatherBits_Unaligned32)
+{
+    // 32 bools starting at bit 3 span five bytes
+    const uint8_t bytes[] = {0xF8, 0xFF, 0x00, 0xFF, 0x07};
+    BOOST_CHECK_EQUAL(drvOmronEIPWrapper::wrap_gatherBits(bytes, 3, 32), 0xFFE01FFFu);
+}
+
+BOOST_AUTO_TEST_SUITE_END()